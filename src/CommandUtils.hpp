@@ -2,11 +2,12 @@
 
 #include <chrono>
 #include <thread>
+#include <tuple>
 #ifdef WINDOWS_BUILD
 #define _HAS_CXX17 1
 #endif
 #include <filesystem>
-#include <subprocess.h>
+#include "Core/ProcessSupervisor.hpp"
 
 #define ANSI_RESET      "\033[0m"
 #define ANSI_GREEN      "\033[1;92m"
@@ -36,42 +37,19 @@ inline bool is_valid_program(const std::string& str) {
     auto s = "where " + str + " > nul 2>&1";
     return system(s.c_str()) == 0;
 #else
-    auto s = "type " + str + " > /dev/null";
-    return system(s.c_str()) == 0;
+    // resolved through cached PATH lookup - no shell process needed
+    const auto path = ProcessSupervisor::resolve_program(str);
+    return path.contains('/') && std::filesystem::exists(path);
 #endif
 }
 
 inline std::string get_program_version_string(const std::string& location) {
-    const char* command_line[] = {location.c_str(), "--version", NULL};
-    struct subprocess_s process;
-    int res = subprocess_create(
-        command_line,
-        subprocess_option_combined_stdout_stderr | subprocess_option_inherit_environment | subprocess_option_search_user_path,
-        &process);
-    if (res != 0) {
-        Log.error("[create {}] Failed to get program version string of \"{}\"", res, location);
-        throw std::runtime_error("Failed to get program version string");
-    }
-
-    while (subprocess_alive(&process)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-
-    FILE* p_stdout = subprocess_stdout(&process);
-
-    // read all contents of p_stdout to std::string
+    int process_ret;
     std::string result;
-    char buf[256];
-    while (fgets(buf, sizeof(buf), p_stdout) != NULL) {
-        result += buf;
-    }
-
-    int process_ret = -1;
-    res             = subprocess_join(&process, &process_ret);
-    subprocess_destroy(&process);
-
-    if (res != 0) {
-        Log.error("[join {}] Failed to get program version string of \"{}\"", res, location);
+    try {
+        std::tie(process_ret, result) = ProcessSupervisor::run(location, {"--version"});
+    } catch (const std::runtime_error& e) {
+        Log.error("Failed to get program version string of \"{}\"", location);
         throw std::runtime_error("Failed to get program version string");
     }
 
@@ -93,59 +71,9 @@ inline std::pair<int, std::string> execute_with_args(const std::string& cmd, con
         return {ret, ""};
     }
 
-    std::vector<const char*> command_line = cmd.empty() ? std::vector<const char*>{} : std::vector<const char*>{cmd.c_str()};
-    for (const auto& a : args) {
-        command_line.push_back(a.c_str());
-    }
-    command_line.push_back(NULL);
-
     // Log.debug("[Execute] {} {}", cmd, args);
 
-    struct subprocess_s process;
-    int res = subprocess_create(
-        command_line.data(),
-        subprocess_option_combined_stdout_stderr | subprocess_option_search_user_path | subprocess_option_inherit_environment,
-        &process);
-    if (res != 0) {
-        Log.error("[create {}] Failed to execute with args", res);
-        throw std::runtime_error("Failed to execute");
-    }
-
-    FILE* p_stdout = subprocess_stdout(&process);
-
-    // read all contents of p_stdout to std::string
-    std::string result;
-
-    int t_diff = 0;
-    char buf[256];
-    do {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-
-        t_diff++;
-
-        while (fgets(buf, sizeof(buf), p_stdout) != NULL) {
-            result += buf;
-        }
-
-        if (!result.empty() && t_diff > 2000) {
-            break;
-        }
-    } while (subprocess_alive(&process));
-
-    while (fgets(buf, sizeof(buf), p_stdout) != NULL) {
-        result += buf;
-    }
-
-    int process_ret = -1;
-    res             = subprocess_join(&process, &process_ret);
-    subprocess_destroy(&process);
-
-    if (res != 0) {
-        Log.error("[join {}] Failed to execute with args", res);
-        throw std::runtime_error("Failed to execute");
-    }
-
-    return {process_ret, result};
+    return ProcessSupervisor::run(cmd, args);
 }
 
 template<typename T>
@@ -14,7 +14,7 @@ static std::string to_string(Archiver::Type type) {
 
 Archiver::~Archiver() { Log.trace("Delete Archiver"); }
 
-Archiver::Archiver(const std::string& ar, bool known_good, const std::string& known_version) : m_location(ar) {
+Archiver::Archiver(const std::string& ar, bool known_good, const std::string& known_version) : m_location(ar), m_executable_path(ProcessSupervisor::resolve_program(ar)) {
     Log.trace("Create archiver \"{}\"", get_location());
 
     if (!known_good && !is_valid_program(get_location())) {
@@ -22,7 +22,8 @@ Archiver::Archiver(const std::string& ar, bool known_good, const std::string& kn
         throw std::runtime_error("Archiver not found");
     }
 
-    const auto ar_version_string = known_version.empty() ? get_program_version_string(get_location()) : known_version;
+    m_version_string              = known_version.empty() ? get_program_version_string(get_executable_path()) : known_version;
+    const auto& ar_version_string = m_version_string;
 
     if (ar_version_string.contains("GNU")) {
         m_type = Type::GNU;
@@ -40,13 +41,15 @@ Archiver::Archiver(const std::string& ar, bool known_good, const std::string& kn
     Log.trace(" - Type: {}", to_string(get_type()));
 }
 
-void Archiver::load_archive_flags(std::vector<std::string>& args, const std::filesystem::path& output_file) const {
+void Archiver::load_archive_flags(std::vector<std::string>& args, const std::filesystem::path& output_file, bool thin) const {
     switch (get_type()) {
         case Type::GNU:
-            args.push_back("rcs");
+            args.push_back(thin ? "rcsT" : "rcs"); // T - thin (--thin is not supported by older versions)
             args.push_back(output_file.string());
             break;
         case Type::CLANG:
+            if (thin)
+                args.push_back("--thin");
             args.push_back("rcs"); // generate lib
             args.push_back(output_file.string());
             break;
@@ -62,6 +65,32 @@ void Archiver::load_archive_flags(std::vector<std::string>& args, const std::fil
     }
 }
 
+bool Archiver::supports_thin_archives() const { return get_type() == Type::GNU || get_type() == Type::CLANG; }
+
+bool Archiver::supports_incremental_update() const { return get_type() == Type::GNU || get_type() == Type::CLANG; }
+
+void Archiver::load_update_flags(std::vector<std::string>& args, const std::filesystem::path& output_file, bool write_index) const {
+    switch (get_type()) {
+        case Type::GNU:
+        case Type::CLANG:
+            args.push_back(write_index ? "rcs" : "rcS"); // S - no symbol index
+            args.push_back(output_file.string());
+            break;
+        default: Log.error("Archiver \"{}\" does not support updates", get_location()); throw std::runtime_error("Archiver not supported");
+    }
+}
+
+void Archiver::load_delete_flags(std::vector<std::string>& args, const std::filesystem::path& output_file, bool write_index) const {
+    switch (get_type()) {
+        case Type::GNU:
+        case Type::CLANG:
+            args.push_back(write_index ? "ds" : "dS");
+            args.push_back(output_file.string());
+            break;
+        default: Log.error("Archiver \"{}\" does not support updates", get_location()); throw std::runtime_error("Archiver not supported");
+    }
+}
+
 void Archiver::load_input_flags(std::vector<std::string>& args, const std::filesystem::path& input_object) const {
     switch (get_type()) {
         case Type::GNU:
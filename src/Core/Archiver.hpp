@@ -10,8 +10,22 @@ public:
 
     Type get_type() const { return m_type; }
     const std::string& get_location() const { return m_location; }
+    const std::string& get_executable_path() const { return m_executable_path; }
+    const std::string& get_version_string() const { return m_version_string; }
+
+    /// thin - archive references objects instead of containing copies (only if supports_thin_archives())
+    void load_archive_flags(std::vector<std::string>& args, const std::filesystem::path& output_file, bool thin) const;
+
+    /// Archiver can create thin archives
+    bool supports_thin_archives() const;
+
+    /// Archiver can replace and delete single members of an existing archive (members are matched by file name)
+    bool supports_incremental_update() const;
+    /// Load flags for replacing/adding members - write_index: write symbol index (last command of an update)
+    void load_update_flags(std::vector<std::string>& args, const std::filesystem::path& output_file, bool write_index) const;
+    /// Load flags for deleting members - write_index: write symbol index (last command of an update)
+    void load_delete_flags(std::vector<std::string>& args, const std::filesystem::path& output_file, bool write_index) const;
 
-    void load_archive_flags(std::vector<std::string>& args, const std::filesystem::path& output_file) const;
     void load_input_flags(std::vector<std::string>& args, const std::filesystem::path& input_object) const;
     void load_input_flag_extension_file(std::vector<std::string>& args, const std::filesystem::path& input_ext_file) const;
     std::string get_archive_extension() const;
@@ -19,5 +33,7 @@ public:
 private:
     Type m_type;
     std::string m_location;
+    std::string m_executable_path; // absolute path of m_location (resolved once)
+    std::string m_version_string;
     std::vector<std::string> m_flags;
 };
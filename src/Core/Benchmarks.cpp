@@ -0,0 +1,131 @@
+#include "Benchmarks.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <subprocess.h>
+#include <vector>
+#include "DependencyParser.hpp"
+#include "MappedFile.hpp"
+#include "ProcessSupervisor.hpp"
+
+#ifdef WINDOWS_BUILD
+static const std::vector<std::string> SPAWN_COMMAND = {"cmd", "/c", "exit"};
+#else
+static const std::vector<std::string> SPAWN_COMMAND = {"true"};
+#endif
+
+static void report(const char* name, std::vector<double>& samples_us) {
+    std::sort(samples_us.begin(), samples_us.end());
+    const auto mean = std::accumulate(samples_us.begin(), samples_us.end(), 0.0) / samples_us.size();
+    Log.info("{:<32} min {:8.1f}us | median {:8.1f}us | mean {:8.1f}us | max {:8.1f}us",
+             name,
+             samples_us.front(),
+             samples_us[samples_us.size() / 2],
+             mean,
+             samples_us.back());
+}
+
+static std::vector<double> measure(int iterations, const std::function<void()>& job) {
+    std::vector<double> samples_us;
+    samples_us.reserve(iterations);
+    for (int i = 0; i < iterations; i++) {
+        const auto t1 = std::chrono::high_resolution_clock::now();
+        job();
+        const auto t2 = std::chrono::high_resolution_clock::now();
+        samples_us.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1000.0);
+    }
+    return samples_us;
+}
+
+void Benchmarks::process_spawn(int iterations) {
+    if (iterations < 1)
+        iterations = 1;
+
+    Log.info("Process spawn benchmark: {} x \"{}\"", iterations, SPAWN_COMMAND[0]);
+
+    auto legacy = measure(iterations, [&]() {
+        std::vector<const char*> command_line;
+        for (const auto& a : SPAWN_COMMAND) {
+            command_line.push_back(a.c_str());
+        }
+        command_line.push_back(NULL);
+
+        struct subprocess_s process;
+        if (subprocess_create(
+                command_line.data(),
+                subprocess_option_combined_stdout_stderr | subprocess_option_search_user_path | subprocess_option_inherit_environment,
+                &process)) {
+            throw std::runtime_error("Failed to execute");
+        }
+        int ret;
+        subprocess_join(&process, &ret);
+        subprocess_destroy(&process);
+    });
+
+    const auto stats_before = ProcessSupervisor::get_spawn_statistics();
+    const std::vector<std::string> args(SPAWN_COMMAND.begin() + 1, SPAWN_COMMAND.end());
+    auto supervised = measure(iterations, [&]() {
+        ProcessSupervisor::run(SPAWN_COMMAND[0], args);
+    });
+    const auto stats_after = ProcessSupervisor::get_spawn_statistics();
+
+    report("subprocess (PATH search)", legacy);
+    report("ProcessSupervisor", supervised);
+    Log.info("ProcessSupervisor spawn only: {:.1f}us per job",
+             (stats_after.total_spawn_ns - stats_before.total_spawn_ns) / 1000.0 / (stats_after.count - stats_before.count));
+}
+
+void Benchmarks::dependency_parser(int iterations) {
+    if (iterations < 1)
+        iterations = 1;
+
+    // typical -MD output of a source including a large part of the standard library
+    const auto dep_path = std::filesystem::temp_directory_path() / "cfxs-build-dependency-benchmark.d";
+    {
+        std::ofstream file(dep_path, std::ios::trunc);
+        file << "/project/output/src/main.cpp.o: /project/src/main.cpp \\\n";
+        for (int i = 0; i < 300; i++) {
+            if (i % 50 == 0) {
+                file << " /project/lib/some\\ dir/header_" << i << ".hpp \\\n";
+            } else {
+                file << " /usr/include/c++/13/bits/header_" << i << ".h \\\n";
+            }
+        }
+        file << " /project/src/main.hpp\n";
+    }
+
+    Log.info("Dependency parser benchmark: {} x \"{}\"", iterations, dep_path);
+
+    size_t legacy_count = 0;
+    auto legacy         = measure(iterations, [&]() {
+        legacy_count = 0;
+        std::ifstream file(dep_path);
+        std::string line;
+        std::getline(file, line);
+        while (std::getline(file, line)) {
+            const auto backslash_terminated = line.ends_with(" \\");
+            std::string_view path(line.data() + line.find_first_not_of(' '),
+                                  line.data() + (backslash_terminated ? (line.length() - 2) : line.length()));
+            legacy_count += !path.empty();
+        }
+    });
+
+    size_t mapped_count = 0;
+    auto mapped         = measure(iterations, [&]() {
+        mapped_count = 0;
+        const MappedFile file(dep_path);
+        DependencyParser::parse_make(file.view(), [&](std::string_view) {
+            mapped_count++;
+            return false;
+        });
+    });
+
+    std::error_code ec;
+    std::filesystem::remove(dep_path, ec);
+
+    report("std::getline", legacy);
+    report("DependencyParser", mapped);
+    Log.info("Paths per file: std::getline {} | DependencyParser {} (including source)", legacy_count, mapped_count);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+class Benchmarks {
+public:
+    /// Measure per job latency of starting and reaping a trivial process
+    /// Compares PATH search + environment copy (subprocess) with ProcessSupervisor (cached path + prebuilt environment)
+    static void process_spawn(int iterations);
+
+    /// Measure parsing of a generated GNU make dependency file (300 headers)
+    /// Compares line based std::getline parsing with the mapped DependencyParser
+    static void dependency_parser(int iterations);
+};
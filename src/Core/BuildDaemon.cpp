@@ -0,0 +1,302 @@
+#include "BuildDaemon.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <spdlog/sinks/base_sink.h>
+#include "Core/Project.hpp"
+#ifndef WINDOWS_BUILD
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define DAEMON_SOCKET_FILE "daemon.sock"
+
+// clients that do not send their request in time are dropped - the daemon handles one request at a time
+static constexpr int REQUEST_TIMEOUT_SECONDS = 5;
+
+std::filesystem::path BuildDaemon::get_socket_path(const std::filesystem::path& output_path) { return output_path / DAEMON_SOCKET_FILE; }
+
+#ifdef WINDOWS_BUILD
+
+void BuildDaemon::serve(const std::filesystem::path&) {
+    Log.error("Build daemon is not supported on Windows");
+    throw std::runtime_error("Build daemon is not supported");
+}
+
+int BuildDaemon::send(const std::filesystem::path&, const Request&) {
+    Log.error("Build daemon is not supported on Windows");
+    return 1;
+}
+
+#else
+
+// response: [frame type, data length, data] * n - last frame is the exit code
+enum class FrameType : uint8_t {
+    LOG       = 0,
+    EXIT_CODE = 1,
+};
+
+static bool write_all(int fd, const char* data, size_t size) {
+    while (size) {
+        const auto written = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static bool read_all(int fd, char* data, size_t size) {
+    while (size) {
+        const auto length = read(fd, data, size);
+        if (length < 0 && errno == EINTR)
+            continue;
+        if (length <= 0)
+            return false;
+        data += length;
+        size -= length;
+    }
+    return true;
+}
+
+static bool write_frame(int fd, FrameType type, std::string_view data) {
+    const uint32_t length = data.size();
+    std::string frame;
+    frame.reserve(sizeof(type) + sizeof(length) + data.size());
+    frame.append(reinterpret_cast<const char*>(&type), sizeof(type));
+    frame.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    frame.append(data);
+    return write_all(fd, frame.data(), frame.size());
+}
+
+/// One "<key> <value>" line per field
+static std::string encode_request(const BuildDaemon::Request& request) {
+    std::string result;
+    for (const auto& name : request.clean) {
+        result += "clean " + name + "\n";
+    }
+    for (const auto& name : request.build) {
+        result += "build " + name + "\n";
+    }
+    if (!request.query.empty())
+        result += "query " + request.query + "\n";
+    if (request.stop)
+        result += "stop\n";
+    return result;
+}
+
+static BuildDaemon::Request decode_request(const std::string& data) {
+    BuildDaemon::Request request;
+    std::istringstream stream(data);
+    std::string line;
+    while (std::getline(stream, line)) {
+        const auto separator = line.find(' ');
+        const auto key       = line.substr(0, separator);
+        const auto value     = separator == std::string::npos ? "" : line.substr(separator + 1);
+        if (key == "clean") {
+            request.clean.push_back(value);
+        } else if (key == "build") {
+            request.build.push_back(value);
+        } else if (key == "query") {
+            request.query = value;
+        } else if (key == "stop") {
+            request.stop = true;
+        }
+    }
+    return request;
+}
+
+static sockaddr_un get_socket_address(const std::filesystem::path& socket_path) {
+    sockaddr_un address = {};
+    address.sun_family  = AF_UNIX;
+
+    const auto path = socket_path.string();
+    if (path.size() >= sizeof(address.sun_path)) {
+        Log.error("Daemon socket path is too long: \"{}\"", socket_path);
+        throw std::runtime_error("Daemon socket path is too long");
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return address;
+}
+
+/// Connect to daemon socket - return -1 if no daemon is listening
+static int connect_socket(const sockaddr_un& address) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// Sends log messages to the client of the current request
+class ClientSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    void set_client(int fd) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        m_fd = fd;
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        if (m_fd < 0)
+            return;
+
+        spdlog::memory_buf_t formatted;
+        formatter_->format(msg, formatted);
+        if (!write_frame(m_fd, FrameType::LOG, std::string_view(formatted.data(), formatted.size())))
+            m_fd = -1; // client disconnected - request is still finished
+    }
+
+    void flush_() override {}
+
+private:
+    int m_fd = -1;
+};
+
+void BuildDaemon::serve(const std::filesystem::path& socket_path) {
+    const auto address = get_socket_address(socket_path);
+
+    // socket file of a daemon that did not exit cleanly
+    if (std::filesystem::exists(socket_path)) {
+        const int fd = connect_socket(address);
+        if (fd >= 0) {
+            close(fd);
+            Log.error("Build daemon is already running (\"{}\")", socket_path);
+            throw std::runtime_error("Build daemon is already running");
+        }
+        std::filesystem::remove(socket_path);
+    }
+
+    const int server = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (server < 0 || bind(server, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(server, 16) != 0) {
+        Log.error("Failed to create daemon socket \"{}\": {}", socket_path, strerror(errno));
+        if (server >= 0)
+            close(server);
+        throw std::runtime_error("Failed to create daemon socket");
+    }
+
+    auto sink = std::make_shared<ClientSink>();
+    sink->set_pattern("[%^%L%$] %v");
+    Log.sinks().push_back(sink);
+
+    Log.info("Build daemon listening on \"{}\"", socket_path);
+
+    const auto start_time  = std::chrono::steady_clock::now();
+    uint32_t request_count = 0;
+    bool running           = true;
+    while (running) {
+        const int client = accept4(server, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            Log.error("Failed to accept daemon client: {}", strerror(errno));
+            break;
+        }
+
+        // request ends when the client shuts down its side of the connection
+        const timeval timeout = {REQUEST_TIMEOUT_SECONDS, 0};
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        std::string data;
+        char buffer[4096];
+        while (true) {
+            const auto length = read(client, buffer, sizeof(buffer));
+            if (length < 0 && errno == EINTR)
+                continue;
+            if (length <= 0)
+                break;
+            data.append(buffer, length);
+        }
+
+        const auto request = decode_request(data);
+        request_count++;
+
+        sink->set_client(client);
+        int32_t exit_code = 0;
+        try {
+            if (request.stop) {
+                Log.info("Stop build daemon");
+                running = false;
+            } else if (request.query == "components") {
+                Project::log_components();
+            } else if (request.query == "status") {
+                const auto uptime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start_time);
+                Log.info("Build daemon pid {}, running for {}s, {} requests", getpid(), uptime.count(), request_count);
+            } else if (!request.query.empty()) {
+                Log.error("Unknown query \"{}\" (components, status)", request.query);
+                exit_code = 1;
+            } else {
+                Project::build_resident(request.clean, request.build);
+            }
+        } catch (const std::runtime_error& e) {
+            Log.error("Failed to build project: {}", e.what());
+            exit_code = 1;
+        }
+        sink->set_client(-1);
+
+        write_frame(client, FrameType::EXIT_CODE, std::string_view(reinterpret_cast<const char*>(&exit_code), sizeof(exit_code)));
+        close(client);
+    }
+
+    Log.sinks().pop_back();
+    close(server);
+    std::error_code ec;
+    std::filesystem::remove(socket_path, ec);
+}
+
+int BuildDaemon::send(const std::filesystem::path& socket_path, const Request& request) {
+    const int fd = connect_socket(get_socket_address(socket_path));
+    if (fd < 0) {
+        Log.error("No build daemon is running for this project (\"{}\") - start one with --daemon", socket_path);
+        return 1;
+    }
+
+    const auto data = encode_request(request);
+    if (!write_all(fd, data.data(), data.size()) || shutdown(fd, SHUT_WR) != 0) {
+        Log.error("Failed to send request to build daemon: {}", strerror(errno));
+        close(fd);
+        return 1;
+    }
+
+    // daemon log is already formatted
+    std::string frame;
+    while (true) {
+        FrameType type;
+        uint32_t length;
+        if (!read_all(fd, reinterpret_cast<char*>(&type), sizeof(type)) || !read_all(fd, reinterpret_cast<char*>(&length), sizeof(length)))
+            break;
+        frame.resize(length);
+        if (!read_all(fd, frame.data(), length))
+            break;
+
+        if (type == FrameType::EXIT_CODE && length == sizeof(int32_t)) {
+            int32_t exit_code;
+            std::memcpy(&exit_code, frame.data(), sizeof(exit_code));
+            close(fd);
+            return exit_code;
+        }
+        if (type == FrameType::LOG) {
+            fwrite(frame.data(), 1, frame.size(), stdout);
+            fflush(stdout);
+        }
+    }
+
+    close(fd);
+    Log.error("Connection to build daemon lost");
+    return 1;
+}
+
+#endif
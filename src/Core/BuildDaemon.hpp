@@ -0,0 +1,27 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// Keeps the configured project in memory and builds for clients connected to a Unix socket (--daemon, --connect)
+/// Lua state, toolchain probes and file state caches stay warm between requests - requests are handled one after another
+/// The log of a request is sent to its client - options of the daemon are used for all requests
+class BuildDaemon {
+public:
+    struct Request {
+        std::vector<std::string> clean;
+        std::vector<std::string> build;
+        std::string query; // "components" or "status"
+        bool stop = false;
+    };
+
+public:
+    /// Socket of project in output directory
+    static std::filesystem::path get_socket_path(const std::filesystem::path& output_path);
+
+    /// Handle requests until a stop request is received
+    static void serve(const std::filesystem::path& socket_path);
+
+    /// Send request to daemon and print its log - return exit code of request
+    static int send(const std::filesystem::path& socket_path, const Request& request);
+};
@@ -0,0 +1,304 @@
+#include "BuildDatabase.hpp"
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include "MappedFile.hpp"
+
+// file layout:
+// magic, path count, entry count
+// paths: [length, characters] * path count
+// entries: [object path index, fingerprint, output hash, source state, dependency count, [path index, state] * dependency count]
+//          * entry count
+// file state: modified time, content hash
+static constexpr char FILE_MAGIC[8] = {'C', 'F', 'X', 'S', 'B', 'D', '0', '4'};
+
+namespace {
+    /// Bounds checked reader of mapped file content
+    class Reader {
+    public:
+        Reader(std::string_view data) : m_data(data) {}
+
+        template<typename T>
+        bool read(T& value) {
+            if (m_data.size() - m_offset < sizeof(T))
+                return false;
+            std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+            m_offset += sizeof(T);
+            return true;
+        }
+
+        bool read(std::string_view& value, size_t length) {
+            if (m_data.size() - m_offset < length)
+                return false;
+            value = m_data.substr(m_offset, length);
+            m_offset += length;
+            return true;
+        }
+
+    private:
+        std::string_view m_data;
+        size_t m_offset = 0;
+    };
+} // namespace
+
+BuildDatabase::BuildDatabase(const std::filesystem::path& path) : m_path(path) {}
+
+void BuildDatabase::load() {
+    std::unique_lock lock(m_mutex);
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    const MappedFile file(m_path);
+    if (!file.is_open())
+        return;
+
+    Reader reader(file.view());
+    char magic[sizeof(FILE_MAGIC)];
+    uint32_t path_count  = 0;
+    uint32_t entry_count = 0;
+    if (!reader.read(magic) || std::memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || !reader.read(path_count) ||
+        !reader.read(entry_count)) {
+        Log.warn("Ignoring invalid build database \"{}\"", m_path);
+        return;
+    }
+
+    const auto fail = [&]() {
+        Log.warn("Ignoring corrupted build database \"{}\"", m_path);
+        m_paths.clear();
+        m_path_ids.clear();
+        m_entries.clear();
+    };
+
+    for (uint32_t i = 0; i < path_count; i++) {
+        uint32_t length;
+        std::string_view path;
+        if (!reader.read(length) || !reader.read(path, length))
+            return fail();
+        intern(path);
+    }
+
+    // counts are checked against the file size - a corrupted count must not allocate
+    if (entry_count > file.size())
+        return fail();
+    m_entries.reserve(entry_count);
+    for (uint32_t i = 0; i < entry_count; i++) {
+        uint32_t object_path;
+        uint32_t dependency_count;
+        Entry entry;
+        if (!reader.read(object_path) || !reader.read(entry.fingerprint) || !reader.read(entry.output_hash) ||
+            !reader.read(entry.source) || !reader.read(dependency_count) || object_path >= path_count || dependency_count > file.size())
+            return fail();
+
+        entry.dependencies.resize(dependency_count);
+        for (auto& dependency : entry.dependencies) {
+            if (!reader.read(dependency.path) || !reader.read(dependency.state) || dependency.path >= path_count)
+                return fail();
+        }
+
+        m_entries[object_path] = std::move(entry);
+    }
+
+    Log.trace("Loaded {} build database entries from \"{}\"", m_entries.size(), m_path);
+}
+
+void BuildDatabase::save() {
+    std::unique_lock lock(m_mutex);
+
+    // objects of sources that were removed from the component
+    {
+        std::lock_guard<std::mutex> lock_used(m_mutex_used);
+        if (std::erase_if(m_entries, [&](const auto& entry) { return !m_used.contains(entry.first); }))
+            m_modified = true;
+        m_used.clear();
+    }
+
+    if (!m_modified)
+        return;
+
+    // only write paths that are still used
+    std::vector<uint32_t> new_index(m_paths.size(), UINT32_MAX);
+    std::vector<uint32_t> used_paths;
+    const auto map_path = [&](uint32_t path) {
+        if (new_index[path] == UINT32_MAX) {
+            new_index[path] = used_paths.size();
+            used_paths.push_back(path);
+        }
+        return new_index[path];
+    };
+    for (const auto& [object_path, entry] : m_entries) {
+        map_path(object_path);
+        for (const auto& dependency : entry.dependencies) {
+            map_path(dependency.path);
+        }
+    }
+
+    // write to temporary file - a crash while writing must not leave a database that marks objects as up to date
+    auto temp_path = m_path;
+    temp_path += ".tmp";
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        Log.warn("Failed to write build database \"{}\"", m_path);
+        return;
+    }
+
+    const auto write = [&](const auto& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    write((uint32_t)used_paths.size());
+    write((uint32_t)m_entries.size());
+    for (const auto path : used_paths) {
+        write((uint32_t)m_paths[path].size());
+        file.write(m_paths[path].data(), m_paths[path].size());
+    }
+    for (const auto& [object_path, entry] : m_entries) {
+        write(new_index[object_path]);
+        write(entry.fingerprint);
+        write(entry.output_hash);
+        write(entry.source);
+        write((uint32_t)entry.dependencies.size());
+        for (const auto& dependency : entry.dependencies) {
+            write(new_index[dependency.path]);
+            write(dependency.state);
+        }
+    }
+    file.close();
+
+    std::error_code ec;
+    if (file)
+        std::filesystem::rename(temp_path, m_path, ec);
+    if (!file || ec) {
+        Log.warn("Failed to write build database \"{}\"", m_path);
+        std::filesystem::remove(temp_path, ec);
+        return;
+    }
+
+    m_modified = false;
+}
+
+void BuildDatabase::clear() {
+    std::unique_lock lock(m_mutex);
+    m_paths.clear();
+    m_path_ids.clear();
+    m_entries.clear();
+    m_modified = false;
+    {
+        std::lock_guard<std::mutex> lock_used(m_mutex_used);
+        m_used.clear();
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(m_path, ec);
+}
+
+bool BuildDatabase::is_up_to_date(const std::string& object_path,
+                                  uint64_t fingerprint,
+                                  std::string_view source_path,
+                                  const FileLookup& lookup) const {
+    std::shared_lock lock(m_mutex);
+
+    const auto path_it = m_path_ids.find(object_path);
+    if (path_it == m_path_ids.end())
+        return false;
+    mark_used(path_it->second);
+    const auto it = m_entries.find(path_it->second);
+    if (it == m_entries.end())
+        return false;
+
+    // any modified time change is a change - restored older versions of files have an older modified time
+    const auto is_unchanged = [&](std::string_view path, const StoredFileState& state) {
+        if (lookup.get_modified_time(path).time_since_epoch().count() == state.modified_time)
+            return true;
+        return state.content_hash && lookup.get_content_hash && lookup.get_content_hash(path) == state.content_hash;
+    };
+
+    const auto& entry = it->second;
+    if (entry.fingerprint != fingerprint || !is_unchanged(source_path, entry.source))
+        return false;
+
+    for (const auto& dependency : entry.dependencies) {
+        if (!is_unchanged(m_paths[dependency.path], dependency.state))
+            return false;
+    }
+
+    return true;
+}
+
+void BuildDatabase::record(const std::string& object_path,
+                           uint64_t fingerprint,
+                           const FileState& source,
+                           const std::vector<std::pair<std::string, FileState>>& dependencies,
+                           uint64_t output_hash) {
+    const auto to_stored = [](const FileState& state) -> StoredFileState {
+        return {state.modified_time.time_since_epoch().count(), state.content_hash};
+    };
+
+    std::unique_lock lock(m_mutex);
+
+    Entry entry;
+    entry.fingerprint = fingerprint;
+    entry.output_hash = output_hash;
+    entry.source      = to_stored(source);
+    entry.dependencies.reserve(dependencies.size());
+    for (const auto& [path, state] : dependencies) {
+        entry.dependencies.push_back({intern(path), to_stored(state)});
+    }
+
+    const auto id = intern(object_path);
+    m_entries[id] = std::move(entry);
+    m_modified    = true;
+    mark_used(id);
+}
+
+uint64_t BuildDatabase::get_output_hash(const std::string& object_path) const {
+    std::shared_lock lock(m_mutex);
+
+    const auto path_it = m_path_ids.find(object_path);
+    if (path_it == m_path_ids.end())
+        return 0;
+    mark_used(path_it->second);
+    const auto it = m_entries.find(path_it->second);
+    return it == m_entries.end() ? 0 : it->second.output_hash;
+}
+
+void BuildDatabase::remove(const std::string& object_path) {
+    std::unique_lock lock(m_mutex);
+
+    const auto path_it = m_path_ids.find(object_path);
+    if (path_it != m_path_ids.end() && m_entries.erase(path_it->second))
+        m_modified = true;
+}
+
+std::vector<std::string> BuildDatabase::get_dependency_paths() const {
+    std::shared_lock lock(m_mutex);
+
+    std::vector<bool> used(m_paths.size(), false);
+    std::vector<std::string> result;
+    for (const auto& [object_path, entry] : m_entries) {
+        for (const auto& dependency : entry.dependencies) {
+            if (used[dependency.path])
+                continue;
+            used[dependency.path] = true;
+            result.push_back(m_paths[dependency.path]);
+        }
+    }
+    return result;
+}
+
+void BuildDatabase::mark_used(uint32_t object_path) const {
+    std::lock_guard<std::mutex> lock(m_mutex_used);
+    m_used.insert(object_path);
+}
+
+uint32_t BuildDatabase::intern(std::string_view path) {
+    const auto it = m_path_ids.find(path);
+    if (it != m_path_ids.end())
+        return it->second;
+
+    const uint32_t id = m_paths.size();
+    m_paths.emplace_back(path);
+    m_path_ids.emplace(m_paths.back(), id);
+    return id;
+}
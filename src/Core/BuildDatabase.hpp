@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// Compile state of the objects of one output directory
+/// Stores the command fingerprint, source modified time and the dependencies with their modified times seen at the last successful compile
+/// Content hashes are stored too if used - files with a changed modified time but the same content are not changes
+/// The hash of the compiled object is stored to find recompiles that produced the same object
+/// Dependency paths are interned - headers are shared by most objects
+/// Entries of objects that were not looked up or recorded since the last save are dropped on save (removed sources)
+class BuildDatabase {
+public:
+    using Time = std::filesystem::file_time_type;
+
+    struct FileState {
+        Time modified_time;
+        uint64_t content_hash = 0; // 0 if content hashes are not used
+    };
+
+    struct FileLookup {
+        std::function<Time(std::string_view)> get_modified_time;    // Time::min() for files that do not exist
+        std::function<uint64_t(std::string_view)> get_content_hash; // optional - only called for files with a changed modified time
+    };
+
+public:
+    BuildDatabase(const std::filesystem::path& path);
+
+    /// Load database file (only once - later calls keep the current state)
+    void load();
+
+    /// Drop entries that were not used since the last save and write database file if anything changed since load
+    void save();
+
+    /// Delete database file and all entries
+    void clear();
+
+    /// Check if object was compiled successfully with the same command from the current source and dependencies
+    bool is_up_to_date(const std::string& object_path,
+                       uint64_t fingerprint,
+                       std::string_view source_path,
+                       const FileLookup& lookup) const;
+
+    /// Record successful compile
+    /// File states are the ones seen when the compile was started
+    /// output_hash - hash of the compiled object (0 if unknown)
+    void record(const std::string& object_path,
+                uint64_t fingerprint,
+                const FileState& source,
+                const std::vector<std::pair<std::string, FileState>>& dependencies,
+                uint64_t output_hash);
+
+    /// Get hash of object recorded at the last successful compile, 0 if unknown
+    uint64_t get_output_hash(const std::string& object_path) const;
+
+    /// Forget object (compile failed)
+    void remove(const std::string& object_path);
+
+    /// Get all dependency paths of recorded objects (each path once)
+    std::vector<std::string> get_dependency_paths() const;
+
+    const std::filesystem::path& get_path() const { return m_path; }
+
+private:
+    struct StoredFileState {
+        int64_t modified_time;
+        uint64_t content_hash;
+    };
+
+    struct Dependency {
+        uint32_t path;
+        StoredFileState state;
+    };
+
+    struct Entry {
+        uint64_t fingerprint;
+        uint64_t output_hash;
+        StoredFileState source;
+        std::vector<Dependency> dependencies;
+    };
+
+    uint32_t intern(std::string_view path);
+    void mark_used(uint32_t object_path) const;
+
+private:
+    std::filesystem::path m_path;
+    mutable std::shared_mutex m_mutex;
+    std::deque<std::string> m_paths; // deque - views in m_path_ids stay valid
+    std::unordered_map<std::string_view, uint32_t> m_path_ids;
+    std::unordered_map<uint32_t, Entry> m_entries; // object path id -> entry
+    mutable std::mutex m_mutex_used;
+    mutable std::unordered_set<uint32_t> m_used; // object path ids looked up or recorded since the last save
+    bool m_loaded   = false;
+    bool m_modified = false;
+};
@@ -0,0 +1,239 @@
+#include "BuildGraph.hpp"
+#include <algorithm>
+
+BuildGraph::Node* BuildGraph::add_node(const std::string& name, std::function<bool()> execute, bool held) {
+    auto node     = std::make_unique<Node>();
+    node->name    = name;
+    node->execute = std::move(execute);
+    node->held    = held;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    node->index = m_nodes.size();
+    m_nodes.emplace_back(std::move(node));
+    m_remaining++;
+
+    auto* new_node = m_nodes.back().get();
+    if (m_executing)
+        schedule_if_ready(new_node);
+    return new_node;
+}
+
+void BuildGraph::add_dependency(Node* node, Node* dependency) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (node->done)
+        return; // skipped
+    if (dependency->done) {
+        if (dependency->failed)
+            skip_node(node);
+        return;
+    }
+
+    dependency->dependents.push_back(node);
+    node->pending_dependencies++;
+
+    // nodes added during execution are not covered by compute_priorities()
+    if (m_executing && !dependency->queued)
+        dependency->priority = std::max(dependency->priority, dependency->cost + node->priority);
+}
+
+void BuildGraph::release(Node* node) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    node->held = false;
+    if (m_executing)
+        schedule_if_ready(node);
+}
+
+size_t BuildGraph::get_node_count() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nodes.size();
+}
+
+void BuildGraph::compute_priorities() {
+    // topological order (Kahn), then accumulate costs from the end of the graph backwards
+    std::vector<Node*> order;
+    order.reserve(m_nodes.size());
+
+    std::vector<int> pending(m_nodes.size());
+    for (auto& node : m_nodes) {
+        pending[node->index] = node->pending_dependencies;
+        if (node->pending_dependencies == 0)
+            order.push_back(node.get());
+    }
+    for (size_t i = 0; i < order.size(); i++) {
+        for (auto* dependent : order[i]->dependents) {
+            if (--pending[dependent->index] == 0)
+                order.push_back(dependent);
+        }
+    }
+
+    // nodes in cycles are never reached here - they fail during execution anyway
+    for (auto& node : m_nodes) {
+        node->priority = node->cost;
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        auto* node = *it;
+        for (auto* dependent : node->dependents) {
+            node->priority = std::max(node->priority, node->cost + dependent->priority);
+        }
+    }
+}
+
+void BuildGraph::schedule_if_ready(Node* node) {
+    if (node->queued || node->done || node->held || node->pending_dependencies != 0)
+        return;
+
+    // cost of nodes added during execution is set after add_node()
+    node->priority = std::max(node->priority, node->cost);
+    node->queued   = true;
+    m_ready.push(node);
+    m_cv.notify_one();
+}
+
+bool BuildGraph::execute(JobPool& job_pool) {
+    start(job_pool);
+    return wait();
+}
+
+void BuildGraph::start(JobPool& job_pool) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    compute_priorities();
+
+    m_ready     = {};
+    m_running   = 0;
+    m_failed    = false;
+    m_stopped   = false;
+    m_exception = nullptr;
+    m_failed_node_names.clear();
+    m_skipped_node_count = 0;
+    m_executing = true;
+    m_open      = true;
+
+    for (auto& node : m_nodes) {
+        schedule_if_ready(node.get());
+    }
+
+    for (int i = 0; i < job_pool.get_max_jobs(); i++) {
+        m_workers.emplace_back(&BuildGraph::worker, this, &job_pool);
+    }
+}
+
+bool BuildGraph::wait() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_open = false;
+        m_cv.notify_all();
+    }
+
+    for (auto& w : m_workers) {
+        w.join();
+    }
+    m_workers.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_executing = false;
+
+    if (m_exception)
+        std::rethrow_exception(m_exception);
+
+    return !m_failed;
+}
+
+void BuildGraph::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failed  = true;
+        m_stopped = true;
+        m_cv.notify_all();
+    }
+    wait();
+}
+
+void BuildGraph::worker(JobPool* job_pool) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [&]() {
+            return m_stopped || !m_ready.empty() || (!m_open && (m_remaining == 0 || m_running == 0));
+        });
+
+        if (m_stopped || (m_ready.empty() && m_remaining == 0))
+            break;
+
+        if (m_ready.empty()) {
+            // graph is complete, nothing running and nothing ready - remaining nodes can never be executed
+            Log.error("Build graph has unresolved dependencies ({} jobs can not be scheduled)", m_remaining);
+            m_failed  = true;
+            m_stopped = true;
+            m_cv.notify_all();
+            break;
+        }
+
+        auto* node = m_ready.top();
+        m_ready.pop();
+        m_running++;
+
+        lock.unlock();
+        bool success = false;
+        try {
+            const auto slot = job_pool->acquire(node->memory_kb);
+            success         = node->execute();
+        } catch (...) {
+            lock.lock();
+            if (!m_exception)
+                m_exception = std::current_exception();
+            lock.unlock();
+        }
+        lock.lock();
+
+        m_running--;
+        const bool first_failure = !success && !m_failed && !m_keep_going;
+        on_node_done(node, success);
+
+        if (first_failure && m_on_fail_fast) {
+            lock.unlock();
+            m_on_fail_fast();
+            lock.lock();
+        }
+    }
+}
+
+void BuildGraph::on_node_done(Node* node, bool success) {
+    m_remaining--;
+    node->done = true;
+
+    if (!success) {
+        // nodes failing after fail-fast stop were terminated - not their own failure
+        if (!m_stopped)
+            m_failed_node_names.push_back(node->name);
+        node->failed = true;
+        m_failed     = true;
+
+        if (m_keep_going) {
+            for (auto* dependent : node->dependents) {
+                skip_node(dependent);
+            }
+        } else {
+            m_stopped = true;
+        }
+    } else {
+        for (auto* dependent : node->dependents) {
+            dependent->pending_dependencies--;
+            schedule_if_ready(dependent);
+        }
+    }
+
+    m_cv.notify_all();
+}
+
+void BuildGraph::skip_node(Node* node) {
+    if (node->done)
+        return;
+
+    node->done   = true;
+    node->failed = true;
+    m_remaining--;
+    m_skipped_node_count++;
+
+    for (auto* dependent : node->dependents) {
+        skip_node(dependent);
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include "JobPool.hpp"
+
+/// Project-wide job graph
+/// Holds compile, archive and link jobs of all components and executes a job as soon as all of its dependencies are done
+/// Ready jobs are started in critical path order (longest remaining chain of job costs first)
+/// Nodes can be added while the graph is executing (jobs start while configure is still creating them)
+/// On failure the graph either stops (fail-fast) or keeps executing all nodes that do not depend on the failed node (keep-going)
+class BuildGraph {
+public:
+    struct Node {
+        std::string name;
+        std::function<bool()> execute; // returns false on failure
+        std::vector<Node*> dependents; // nodes waiting for this node
+        int pending_dependencies = 0;  // number of unfinished dependencies
+        bool held                = false; // not scheduled before release() is called
+        bool queued              = false; // in ready queue or executed
+        bool done                = false;
+        bool failed              = false; // failed or skipped because a dependency failed
+        uint64_t cost            = 1; // expected duration of this node
+        uint64_t memory_kb       = 0; // expected peak memory usage of this node (0 = unknown)
+        uint64_t priority        = 0; // cost of longest path from this node to the end of the graph
+        size_t index             = 0; // creation order - tie breaker for equal priorities
+    };
+
+public:
+    /// keep_going - continue with independent nodes after a node failed
+    /// on_fail_fast - called (without graph lock) when the first node fails and the graph is not in keep_going mode
+    BuildGraph(bool keep_going = false, std::function<void()> on_fail_fast = {}) :
+        m_keep_going(keep_going), m_on_fail_fast(std::move(on_fail_fast)) {}
+
+    /// Create new job node
+    /// held - node is not started before release(node) is called (dependencies can be added while graph is executing)
+    Node* add_node(const std::string& name, std::function<bool()> execute, bool held = false);
+
+    /// node will not be executed before dependency is done
+    /// node must not be started yet (not executing graph, held or waiting for other dependencies)
+    void add_dependency(Node* node, Node* dependency);
+
+    /// Allow held node to start when its dependencies are done
+    void release(Node* node);
+
+    /// Execute all nodes, running at most job_pool.get_max_jobs() nodes at the same time
+    /// Returns false if a node failed, rethrows the first exception thrown by a node
+    bool execute(JobPool& job_pool);
+
+    /// Start executing nodes in background - more nodes can be added until wait() is called
+    void start(JobPool& job_pool);
+
+    /// Wait for all nodes to finish - same result as execute()
+    bool wait();
+
+    /// Do not start any more nodes and wait for running nodes to finish
+    void cancel();
+
+    size_t get_node_count() const;
+
+    /// Names of failed nodes (valid after wait())
+    const std::vector<std::string>& get_failed_node_names() const { return m_failed_node_names; }
+
+    /// Number of nodes not executed because a dependency failed (valid after wait())
+    size_t get_skipped_node_count() const { return m_skipped_node_count; }
+
+private:
+    void compute_priorities();
+    void schedule_if_ready(Node* node);
+    void worker(JobPool* job_pool);
+    void on_node_done(Node* node, bool success);
+    void skip_node(Node* node);
+
+    struct ComparePriority {
+        bool operator()(const Node* a, const Node* b) const {
+            if (a->priority != b->priority)
+                return a->priority < b->priority;
+            return a->index > b->index;
+        }
+    };
+
+private:
+    bool m_keep_going;
+    std::function<void()> m_on_fail_fast;
+
+    std::vector<std::unique_ptr<Node>> m_nodes;
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::priority_queue<Node*, std::vector<Node*>, ComparePriority> m_ready;
+    size_t m_remaining = 0;
+    size_t m_running   = 0;
+    bool m_executing   = false;
+    bool m_open        = false; // more nodes can be added
+    bool m_failed      = false; // a node failed
+    bool m_stopped     = false; // no new nodes are started
+    std::exception_ptr m_exception;
+    std::vector<std::string> m_failed_node_names;
+    size_t m_skipped_node_count = 0;
+};
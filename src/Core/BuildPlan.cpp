@@ -0,0 +1,162 @@
+#include "BuildPlan.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include "Core/ContentHashCache.hpp"
+#include "Core/FileStatCache.hpp"
+#include "Core/GIT.hpp"
+#include "MappedFile.hpp"
+
+// file layout: magic, project path, definitions, [input type, key, value] * n, content
+static constexpr char FILE_MAGIC[8] = {'C', 'F', 'X', 'S', 'B', 'P', '0', '2'};
+
+static std::vector<BuildPlan::Input> s_recorded_inputs;
+static std::set<std::pair<BuildPlan::InputType, std::string>> s_recorded_keys;
+static bool s_volatile_input = false;
+
+static const char* to_string(BuildPlan::InputType type) {
+    switch (type) {
+        case BuildPlan::InputType::SCRIPT: return "script";
+        case BuildPlan::InputType::FILE: return "file";
+        case BuildPlan::InputType::EXISTS: return "exists";
+        case BuildPlan::InputType::ENVIRONMENT: return "environment variable";
+        case BuildPlan::InputType::GIT_INFO: return "git info";
+        case BuildPlan::InputType::GIT_HEAD: return "git import";
+        case BuildPlan::InputType::PROGRAM: return "program";
+    }
+    return "???";
+}
+
+void BuildPlan::begin_recording() {
+    s_recorded_inputs.clear();
+    s_recorded_keys.clear();
+    s_volatile_input = false;
+}
+
+void BuildPlan::record_input(InputType type, const std::string& key, const std::string& value) {
+    if (s_recorded_keys.emplace(type, key).second)
+        s_recorded_inputs.push_back({type, key, value});
+}
+
+void BuildPlan::record_volatile_input() { s_volatile_input = true; }
+
+const std::vector<BuildPlan::Input>& BuildPlan::get_recorded_inputs() { return s_recorded_inputs; }
+bool BuildPlan::have_volatile_input() { return s_volatile_input; }
+
+std::string BuildPlan::read_input(InputType type, const std::string& key) {
+    switch (type) {
+        case InputType::SCRIPT:
+        case InputType::FILE: {
+            const MappedFile file(key);
+            return file.is_open() ? std::to_string(ContentHashCache::hash(file.view())) : "";
+        }
+        case InputType::EXISTS: return std::filesystem::exists(key) ? "1" : "0";
+        case InputType::ENVIRONMENT: {
+            // unset and empty variables are different values
+            const char* value = std::getenv(key.c_str());
+            return value ? std::string("=") + value : "";
+        }
+        case InputType::GIT_INFO: {
+            GIT git(key);
+            if (!git.is_git_repository())
+                return "";
+            return git.get_current_branch() + "\n" + git.get_current_short_hash();
+        }
+        case InputType::GIT_HEAD: return GIT(key).get_head_commit();
+        case InputType::PROGRAM: {
+            const auto stat = FileStatCache::stat(key);
+            if (!stat.exists)
+                return "";
+            return std::to_string(stat.size) + ":" + std::to_string(stat.modified_time.time_since_epoch().count());
+        }
+    }
+    return "";
+}
+
+void BuildPlan::save(const std::filesystem::path& path,
+                     const std::filesystem::path& project_path,
+                     const std::vector<std::string>& definitions,
+                     const std::vector<Input>& inputs,
+                     const std::string& content) {
+    Writer writer;
+    writer.write(FILE_MAGIC);
+    writer.write(project_path);
+    writer.write(definitions);
+    writer.write((uint32_t)inputs.size());
+    for (const auto& input : inputs) {
+        writer.write(input.type);
+        writer.write(input.key);
+        writer.write(input.value);
+    }
+    writer.write(content);
+
+    // write to temporary file - a partially written plan must not be loaded
+    auto temp_path = path;
+    temp_path += ".tmp";
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (file.is_open())
+        file.write(writer.get_data().data(), writer.get_data().size());
+    file.close();
+
+    std::error_code ec;
+    if (file)
+        std::filesystem::rename(temp_path, path, ec);
+    if (!file || ec) {
+        Log.warn("Failed to write build plan \"{}\"", path);
+        std::filesystem::remove(temp_path, ec);
+        return;
+    }
+
+    Log.trace("Saved build plan with {} inputs", inputs.size());
+}
+
+bool BuildPlan::load(const std::filesystem::path& path,
+                     const std::filesystem::path& project_path,
+                     const std::vector<std::string>& definitions,
+                     std::vector<Input>& inputs,
+                     std::string& content) {
+    const MappedFile file(path);
+    if (!file.is_open())
+        return false;
+
+    Reader reader(file.view());
+    char magic[sizeof(FILE_MAGIC)];
+    std::filesystem::path stored_project_path;
+    std::vector<std::string> stored_definitions;
+    uint32_t input_count = 0;
+    reader.read(magic);
+    reader.read(stored_project_path);
+    reader.read(stored_definitions);
+    reader.read(input_count);
+    if (reader.failed() || std::memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        Log.trace("Ignoring invalid build plan \"{}\"", path);
+        return false;
+    }
+
+    if (stored_project_path != project_path || stored_definitions != definitions) {
+        Log.trace("Build plan outdated - project location or definitions changed");
+        return false;
+    }
+
+    inputs.clear();
+    for (uint32_t i = 0; i < input_count && !reader.failed(); i++) {
+        auto& input = inputs.emplace_back();
+        reader.read(input.type);
+        reader.read(input.key);
+        reader.read(input.value);
+    }
+    reader.read(content);
+    if (reader.failed()) {
+        Log.trace("Ignoring invalid build plan \"{}\"", path);
+        return false;
+    }
+
+    for (const auto& input : inputs) {
+        if (read_input(input.type, input.key) != input.value) {
+            Log.trace("Build plan outdated - {} \"{}\" changed", to_string(input.type), input.key);
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/// Components, global options and toolchains created by the .cfxs-build scripts (plan.bin in output directory)
+/// A saved plan replaces executing the scripts while everything the scripts read is unchanged:
+/// script contents, script definitions, results of exists(), os.getenv() and get_git_info(), git import checkouts and toolchain executables
+/// Scripts can not read other files or run programs (io, dofile, loadfile, require and os.execute are removed)
+class BuildPlan {
+public:
+    enum class InputType : uint8_t {
+        SCRIPT,      // content hash of executed script
+        FILE,        // content hash of other file ("" if missing)
+        EXISTS,      // exists(path)
+        ENVIRONMENT, // os.getenv(name)
+        GIT_INFO,    // get_git_info() of directory
+        GIT_HEAD,    // checked out commit of git import
+        PROGRAM,     // size and modified time of toolchain executable
+    };
+
+    struct Input {
+        InputType type;
+        std::string key;
+        std::string value;
+    };
+
+    /// Binary plan content
+    class Writer {
+    public:
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        void write(const T& value) {
+            m_data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void write(std::string_view value) {
+            write((uint32_t)value.size());
+            m_data.append(value);
+        }
+        void write(const std::string& value) { write(std::string_view(value)); }
+        void write(const std::filesystem::path& value) { write(value.string()); }
+
+        template<typename T>
+        void write(const std::vector<T>& values) {
+            write((uint32_t)values.size());
+            for (const auto& value : values) {
+                write(value);
+            }
+        }
+
+        const std::string& get_data() const { return m_data; }
+
+    private:
+        std::string m_data;
+    };
+
+    /// Bounds checked reader of plan content - values read after an error are empty
+    class Reader {
+    public:
+        Reader(std::string_view data) : m_data(data) {}
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        void read(T& value) {
+            if (m_failed || m_data.size() - m_offset < sizeof(T)) {
+                m_failed = true;
+                std::memset(&value, 0, sizeof(T));
+                return;
+            }
+            std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+            m_offset += sizeof(T);
+        }
+
+        void read(std::string& value) {
+            uint32_t length = 0;
+            read(length);
+            if (m_failed || m_data.size() - m_offset < length) {
+                m_failed = true;
+                value.clear();
+                return;
+            }
+            value.assign(m_data.data() + m_offset, length);
+            m_offset += length;
+        }
+
+        void read(std::filesystem::path& value) {
+            std::string str;
+            read(str);
+            value = str;
+        }
+
+        template<typename T>
+        void read(std::vector<T>& values) {
+            uint32_t count = 0;
+            read(count);
+            values.clear();
+            for (uint32_t i = 0; i < count && !m_failed; i++) {
+                read(values.emplace_back());
+            }
+        }
+
+        bool failed() const { return m_failed; }
+
+    private:
+        std::string_view m_data;
+        size_t m_offset = 0;
+        bool m_failed   = false;
+    };
+
+public:
+    /// Start recording inputs of the scripts that are executed next
+    static void begin_recording();
+
+    /// Record value read by a script (only the first value of an input is kept)
+    static void record_input(InputType type, const std::string& key, const std::string& value);
+
+    /// Script read something that is not an input (time, debug library) - plan can not be reused
+    static void record_volatile_input();
+
+    static const std::vector<Input>& get_recorded_inputs();
+    static bool have_volatile_input();
+
+    /// Read current value of input
+    static std::string read_input(InputType type, const std::string& key);
+
+    /// Write plan file - key (project location, definitions and inputs) and content
+    static void save(const std::filesystem::path& path,
+                     const std::filesystem::path& project_path,
+                     const std::vector<std::string>& definitions,
+                     const std::vector<Input>& inputs,
+                     const std::string& content);
+
+    /// Read plan file if its key matches - inputs are set to the stored inputs
+    /// Return false if there is no plan or something the scripts read has changed
+    static bool load(const std::filesystem::path& path,
+                     const std::filesystem::path& project_path,
+                     const std::vector<std::string>& definitions,
+                     std::vector<Input>& inputs,
+                     std::string& content);
+};
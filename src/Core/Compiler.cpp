@@ -2,7 +2,10 @@
 #include <CommandUtils.hpp>
 #include <stdexcept>
 #include <fstream>
+#include "Core/DependencyParser.hpp"
 #include "FilesystemUtils.hpp"
+#include "HashUtils.hpp"
+#include "MappedFile.hpp"
 
 static std::string to_string(Compiler::Standard standard) {
     switch (standard) {
@@ -71,7 +74,10 @@ Compiler::Compiler(Language language,
                    const std::string& standard_num,
                    bool known_good,
                    const std::string& known_version) :
-    m_language(language), m_location(location) {
+    m_language(language),
+    m_location(location),
+    m_executable_path(ProcessSupervisor::resolve_program(location)),
+    m_standard_number(standard_num) {
     Log.trace("Create {} compiler \"{}\" with standard \"{}\"", to_string(get_language()), get_location(), standard_num);
 
     if (!known_good && !is_valid_program(get_location())) {
@@ -79,7 +85,8 @@ Compiler::Compiler(Language language,
         throw std::runtime_error("Compiler not found");
     }
 
-    const auto compiler_version_string = known_version.empty() ? get_program_version_string(get_location()) : known_version;
+    m_version_string                    = known_version.empty() ? get_program_version_string(get_executable_path()) : known_version;
+    const auto& compiler_version_string = m_version_string;
 
     if (compiler_version_string.contains("GNU") || compiler_version_string.contains("gcc") || compiler_version_string.contains("g++")) {
         m_type = Type::GNU;
@@ -104,6 +111,15 @@ Compiler::Compiler(Language language,
 
     Log.trace(" - Type: {}", to_string(get_type()));
 
+    // executable size and modified time - version string does not change with every rebuild of a toolchain
+    std::error_code ec;
+    const auto executable = std::filesystem::weakly_canonical(get_executable_path(), ec);
+    const auto size       = std::filesystem::file_size(executable, ec);
+    const auto mod_time   = std::filesystem::last_write_time(executable, ec);
+    m_identity            = HashUtils::fnv1a_field(compiler_version_string, HashUtils::fnv1a_field(executable.string()));
+    m_identity            = HashUtils::fnv1a_field(std::to_string(size), m_identity);
+    m_identity            = HashUtils::fnv1a_field(std::to_string(mod_time.time_since_epoch().count()), m_identity);
+
     if (get_language() == Language::ASM) {
         m_standard = Standard::ASM;
     } else if (get_language() == Language::C) {
@@ -328,7 +344,7 @@ std::vector<std::string> Compiler::get_stdlib_paths() const {
         } else {
             throw std::runtime_error("Unsupported language");
         }
-        auto [ret, output] = execute_with_args(get_location(), args);
+        auto [ret, output] = execute_with_args(get_executable_path(), args);
         if (ret) {
             throw std::runtime_error("Failed to get stdlib paths");
         }
@@ -417,45 +433,39 @@ std::string Compiler::get_pch_include_flags(const std::filesystem::path& pch_gen
 }
 
 void Compiler::iterate_dependency_file(const std::filesystem::path& dependency_file,
+                                       const std::filesystem::path& source_file,
                                        const std::function<bool(std::string_view)>& callback) const {
-    std::ifstream dep_file(dependency_file);
+    const MappedFile file(dependency_file);
+    if (!file.is_open())
+        return;
+
+    const auto source_path = source_file.string();
 
     if (get_type() == Type::GNU || get_type() == Type::CLANG) {
         /* Format:
-            object/path/obj.o: \
-            dep/path/a.cpp \
-            dep/path/b.hpp \
-            dep/path/c.hpp \
+            object/path/obj.o: dep/path/a.cpp \
+              dep/path/b.hpp dep/path/with\ space.hpp \
+              dep/path/c.hpp
+            dep/path/b.hpp:
         */
-        // Format includes the compiled cpp file as well.
-        // TODO: don't check the actual compiled file - other cpp files should be ok to check
-        std::string line;
-        std::getline(dep_file, line); // skip first line
-        while (std::getline(dep_file, line)) {
-            // trim line spaces from beginning and remove potential " \" at the end of the line
-            const auto backslash_terminated = line.ends_with(" \\");
-            std::string_view line_sv(line.data() + line.find_first_not_of(' '),
-                                     line.data() + (backslash_terminated ? (line.length() - 2) : line.length()));
-
-            const bool should_return = callback(line_sv);
-            if (should_return)
-                return;
-        }
+        DependencyParser::parse_make(file.view(), [&](std::string_view path) -> bool {
+            if (path == source_path)
+                return false; // compiled source is the first prerequisite
+            return callback(path);
+        });
     } else if (get_type() == Type::IAR) {
         /* Format:
             dep/path/a.hpp
             dep/path/b.hpp
             dep/path/c.hpp
         */
-        std::string line;
-        while (std::getline(dep_file, line)) {
-            if (line.starts_with("C:\\Program Files (x86)\\IAR Systems")) { // Skip IAR system includes
-                continue;
-            }
-            const bool should_return = callback(line);
-            if (should_return)
-                return;
-        }
+        DependencyParser::parse_lines(file.view(), [&](std::string_view path) -> bool {
+            if (path.starts_with("C:\\Program Files (x86)\\IAR Systems")) // Skip IAR system includes
+                return false;
+            if (path == source_path)
+                return false;
+            return callback(path);
+        });
     } else if (get_type() == Type::MSVC) {
         throw std::runtime_error("Not implemented");
     } else {
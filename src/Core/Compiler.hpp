@@ -21,7 +21,13 @@ public:
     Standard get_standard() const { return m_standard; }
     Type get_type() const { return m_type; }
     const std::string& get_location() const { return m_location; }
+    const std::string& get_executable_path() const { return m_executable_path; }
     const std::vector<std::string>& get_options() const { return m_flags; }
+    const std::string& get_version_string() const { return m_version_string; }
+    const std::string& get_standard_number() const { return m_standard_number; }
+
+    /// Hash of version and executable file - changes when the compiler is replaced or updated
+    uint64_t get_identity() const { return m_identity; }
 
     /// Load flags for generating dependency list
     void load_dependency_flags(std::vector<std::string>& flags, const std::filesystem::path& out_path) const;
@@ -39,7 +45,10 @@ public:
     void push_compile_definition(std::vector<std::string>& flags, const std::string& compile_definition) const;
 
     /// Parse + iterate dependency file
-    void iterate_dependency_file(const std::filesystem::path& dependency_file, const std::function<bool(std::string_view)>& callback) const;
+    /// source_file - compiled source, not passed to callback
+    void iterate_dependency_file(const std::filesystem::path& dependency_file,
+                                 const std::filesystem::path& source_file,
+                                 const std::function<bool(std::string_view)>& callback) const;
 
     /// Get flag for including pch
     std::string get_pch_include_flags(const std::filesystem::path& pch_gen_path) const;
@@ -56,7 +65,11 @@ private:
     Language m_language;
     Standard m_standard;
     std::string m_location;
+    std::string m_executable_path; // absolute path of m_location (resolved once)
+    std::string m_version_string;
+    std::string m_standard_number; // standard as passed by script ("17")
     std::vector<std::string> m_flags;
+    uint64_t m_identity = 0;
 };
 
 inline std::string to_string(Compiler::Language language) {
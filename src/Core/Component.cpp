@@ -10,13 +10,18 @@
 #include <stdexcept>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include "Core/Archiver.hpp"
 #include "Core/Compiler.hpp"
-#include "Core/FunctionWorker.hpp"
+#include "Core/ContentHashCache.hpp"
+#include "Core/FileStatCache.hpp"
 #include "Core/GIT.hpp"
 #include "Core/Linker.hpp"
+#include "Core/ObjectHash.hpp"
 #include "Core/SourceEntry.hpp"
 #include "FilesystemUtils.hpp"
+#include "HashUtils.hpp"
+#include "MappedFile.hpp"
 #include "RegexUtils.hpp"
 #include <fstream>
 #include <sstream>
@@ -25,32 +30,36 @@
 #include "LuaBackend.hpp"
 #include "lauxlib.h"
 
+#define BUILD_DATABASE_FILE "build_db.bin"
+
 extern std::vector<std::filesystem::path> s_script_path_stack;
 extern std::vector<std::filesystem::path> s_source_location_stack;
 
-////////////////////////////////////
-// File modified cache
-static std::unordered_map<size_t, std::filesystem::file_time_type> s_file_modified_cache;
-static std::mutex s_mutex_file_modified_cache;
+// file_time_type::min() if file does not exist
+static std::filesystem::file_time_type get_file_modified_time(std::string_view path) {
+    return FileStatCache::get(path).modified_time; //
+}
 
-uint32_t s_fmc_hits   = 0;
-uint32_t s_fmc_misses = 0;
+////////////////////////////////////
+// Content hashes (--content-hash)
+extern std::unique_ptr<ContentHashCache> e_content_hash_cache;
 
-std::filesystem::file_time_type get_file_modified_time(std::string_view path) {
-    const auto hash = std::hash<std::string_view>{}(path);
+// 0 if content hashes are not used
+static uint64_t get_file_content_hash(std::string_view path) {
+    return e_content_hash_cache ? e_content_hash_cache->get(path) : 0; //
+}
 
-    std::lock_guard<std::mutex> _lock(s_mutex_file_modified_cache);
+// hash of file content with the size and modified time of stat - the file may have changed since it was hashed in this run
+static uint64_t get_current_file_content_hash(std::string_view path, const FileStatCache::Stat& stat) {
+    return e_content_hash_cache ? e_content_hash_cache->get_current(path, stat) : 0; //
+}
 
-    const auto it = s_file_modified_cache.find(hash);
-    if (it != s_file_modified_cache.end()) {
-        s_fmc_hits++;
-        return it->second;
-    } else {
-        s_fmc_misses++;
-        const auto mod_time         = std::filesystem::last_write_time(path);
-        s_file_modified_cache[hash] = mod_time;
-        return mod_time;
-    }
+static BuildDatabase::FileLookup get_file_lookup() {
+    BuildDatabase::FileLookup lookup;
+    lookup.get_modified_time = get_file_modified_time;
+    if (e_content_hash_cache)
+        lookup.get_content_hash = get_file_content_hash;
+    return lookup;
 }
 
 ////////////////////////////////////
@@ -73,6 +82,7 @@ Component::Component(Type type,
     m_script_path(std::filesystem::weakly_canonical(script_path)),
     m_root_path(std::filesystem::weakly_canonical(root_path)),
     m_local_output_directory(std::filesystem::weakly_canonical(local_output_directory)),
+    m_build_database(m_local_output_directory / BUILD_DATABASE_FILE),
     m_namespace(ns) {}
 
 Component::~Component() {}
@@ -81,6 +91,7 @@ Component::~Component() {}
 std::vector<std::string> s_TempFileExtensions = {
     ".o",
     ".dep",
+    ".tmp", // timestamp files of older versions
 };
 
 static void prepare_and_push_flags(std::vector<std::string>& flags, const std::string& flag) {
@@ -191,7 +202,9 @@ bool Component::process_source_file_path(const SourceFilePath& e,
                                          std::shared_ptr<Compiler> c_compiler,
                                          std::shared_ptr<Compiler> cpp_compiler,
                                          std::shared_ptr<Compiler> asm_compiler,
-                                         bool force_compile) {
+                                         uint64_t pch_state,
+                                         bool force_compile,
+                                         uint64_t* fingerprint) {
     const auto output_dir = get_source_output_directory(e);
     const auto* compiler  = get_compiler_from_extension(e.path, c_compiler, cpp_compiler, asm_compiler);
 
@@ -208,12 +221,7 @@ bool Component::process_source_file_path(const SourceFilePath& e,
         m_mutex_output_object_paths.unlock();
     }
 
-    // temporary and dependency file paths
-    const auto dep_path    = output_dir / (src_name + compiler->get_dependency_extension());
-    const auto ts_temp     = output_dir / (src_name + ".tmp");
-    const auto ts_dep_temp = output_dir / (src_name + ".dep.tmp");
-
-    // initialize output directory for temp and build files
+    // initialize output directory for build files
     m_mutex_source_paths.lock();
     if (!std::filesystem::exists(output_dir)) {
         try {
@@ -223,70 +231,6 @@ bool Component::process_source_file_path(const SourceFilePath& e,
     }
     m_mutex_source_paths.unlock();
 
-    bool need_build = false;
-
-    if (!FilesystemUtils::all_exist(ts_temp, ts_dep_temp, dep_path, obj_path)) {
-        need_build = true;
-        // create and write modify empty file ts_temp
-        try {
-            std::ofstream ts_temp_file(ts_temp);
-            ts_temp_file.close();
-            std::ofstream ts_dep_temp_file(ts_dep_temp);
-            ts_dep_temp_file.close();
-        } catch (const std::exception& e) {
-            Log.error("[{}] Failed to create timestamp file at \"{}\": {}", get_name(), ts_temp, e.what());
-            throw std::runtime_error("Failed to create timestamp file");
-        }
-    } else {
-        auto src_modified_time     = std::filesystem::last_write_time(e.path);  // source file
-        auto ts_mark_modified_time = std::filesystem::last_write_time(ts_temp); // modified time tracker
-
-        const bool source_modified = src_modified_time > ts_mark_modified_time;
-
-        if (source_modified) {
-            need_build = true;
-            // set ts_temp write time to src_modified_time
-            try {
-                std::filesystem::last_write_time(ts_temp, src_modified_time);
-            } catch (const std::exception& e) {
-                Log.error("[{}] Failed to set timestamp file \"{}\" time: {}", get_name(), ts_temp, e.what());
-                throw std::runtime_error("Failed to set timestamp file time");
-            }
-        } else {
-            const auto ts_dep_modified_time = std::filesystem::last_write_time(ts_dep_temp);
-
-            // iterate deps
-            // parse dep_path file
-            compiler->iterate_dependency_file(dep_path, [&](std::string_view path) -> bool {
-                if (e.path == path)
-                    return false; // ignore "this" compile unit
-                if (!std::filesystem::exists(path))
-                    return false;
-                // check if dep file is newer than obj file
-                auto dependency_modified_time = get_file_modified_time(path);
-                if (dependency_modified_time > ts_dep_modified_time) { // always check to write latest change
-                    // set ts_temp write time to src_modified_time
-                    try {
-                        // std::filesystem::last_write_time(ts_dep_temp, dependency_modified_time);
-                        std::ofstream ts_dep_temp_file(ts_dep_temp);
-                        ts_dep_temp_file.close();
-                    } catch (const std::exception& e) {
-                        Log.error("[{}] Failed to set timestamp file \"{}\" time: {}", get_name(), ts_temp, e.what());
-                        throw std::runtime_error("Failed to set timestamp file time");
-                    }
-                    need_build = true;
-                    return true; // break
-                }
-
-                return false; // dont break
-            });
-        }
-    }
-
-    // return if build is not needed and build is not externally forced
-    if (!need_build && !force_compile)
-        return false;
-
     // create compile entry
     auto compile_entry          = std::make_unique<CompileEntry>();
     compile_entry->source_entry = std::make_unique<SourceEntry>(compiler, e.path, output_dir, obj_path, e.is_precompiled_header_file);
@@ -349,11 +293,18 @@ bool Component::process_source_file_path(const SourceFilePath& e,
         for (const auto& val : get_compile_options()) {
             prepare_and_push_flags(compile_entry->compile_args, val.value);
         }
+        for (const auto& val : m_pch_compile_options) {
+            prepare_and_push_flags(compile_entry->compile_args, val);
+        }
     } else {
         for (const auto& val : get_compile_options()) {
             auto v = option_replacement(val.value);
             prepare_and_push_flags(compile_entry->compile_args, v);
         }
+        for (const auto& val : m_pch_compile_options) {
+            auto v = option_replacement(val);
+            prepare_and_push_flags(compile_entry->compile_args, v);
+        }
     }
 
     // [Library paths/definitions/options]
@@ -391,7 +342,29 @@ bool Component::process_source_file_path(const SourceFilePath& e,
         }
     }
 
-    compile_entry->compiler = compiler;
+    compile_entry->compiler     = compiler;
+    compile_entry->command_hash = HashUtils::fnv1a_field(source_entry.get_source_file_path().string(),
+                                                         HashUtils::fnv1a_field(compiler->get_location()));
+    for (const auto& arg : compile_entry->compile_args) {
+        compile_entry->command_hash = HashUtils::fnv1a_field(arg, compile_entry->command_hash);
+    }
+
+    compile_entry->fingerprint = HashUtils::fnv1a_field(std::to_string(pch_state),
+                                                        HashUtils::fnv1a_field(std::to_string(compiler->get_identity()),
+                                                                               compile_entry->command_hash));
+    if (fingerprint)
+        *fingerprint = compile_entry->fingerprint;
+
+    // object is up to date if it was compiled successfully with the same command and no source or dependency changed since
+    if (force_compile) {
+        // entry is invalid even if this compile does not happen (cancelled build)
+        m_build_database.remove(obj_path.string());
+    } else if (std::filesystem::exists(obj_path)) {
+        const bool up_to_date =
+            m_build_database.is_up_to_date(obj_path.string(), compile_entry->fingerprint, e.path.string(), get_file_lookup());
+        if (up_to_date)
+            return false;
+    }
 
     // write command file @ output_dir/cmd.txt
     const auto dir    = replace_string(compile_entry->source_entry->get_output_directory().string(), "\\", "\\\\");
@@ -421,9 +394,13 @@ bool Component::process_source_file_path(const SourceFilePath& e,
     cmd_file << ("},\n");
     cmd_file.close();
 
+    auto* entry = compile_entry.get();
     m_mutex_compile_entries.lock();
     m_compile_entries.emplace_back(std::move(compile_entry));
     m_mutex_compile_entries.unlock();
+
+    if (m_on_compile_entry)
+        m_on_compile_entry(entry);
     return true;
 }
 
@@ -431,14 +408,35 @@ void Component::configure(std::shared_ptr<Compiler> c_compiler,
                           std::shared_ptr<Compiler> cpp_compiler,
                           std::shared_ptr<Compiler> asm_compiler,
                           std::shared_ptr<Linker> linker,
-                          std::shared_ptr<Archiver> archiver) {
-    m_linker   = linker;
-    m_archiver = archiver;
+                          std::shared_ptr<Archiver> archiver,
+                          std::function<void(CompileEntry*)> on_compile_entry) {
+    m_linker           = linker;
+    m_archiver         = archiver;
+    m_on_compile_entry = std::move(on_compile_entry);
     Log.info("Configure [{}]", get_name());
     const auto configure_t1 = std::chrono::high_resolution_clock::now();
 
-    // Add requested sources to path vector
-    auto source_file_paths = get_source_file_paths();
+    m_build_database.load();
+
+    // state of the previous configure (--watch configures again after changes)
+    m_compile_entries.clear();
+    m_output_object_paths.clear();
+    m_pch_compile_options.clear();
+    m_did_build = false;
+
+    // Add requested sources to path vector - only searched again if files were added or removed
+    if (!m_source_file_paths || m_rescan_source_file_paths) {
+        auto source_file_paths = get_source_file_paths();
+        // objects of removed sources must not be archived/linked anymore
+        const auto same_path = [](const SourceFilePath& a, const SourceFilePath& b) {
+            return a.path == b.path;
+        };
+        if (m_source_file_paths && !std::ranges::equal(source_file_paths, *m_source_file_paths, same_path))
+            m_force_finalize = true;
+        m_source_file_paths        = std::move(source_file_paths);
+        m_rescan_source_file_paths = false;
+    }
+    const auto& source_file_paths = *m_source_file_paths;
 
     const auto& pch = get_precompiled_header();
     // XXX: TEMPORARY:
@@ -450,7 +448,8 @@ void Component::configure(std::shared_ptr<Compiler> c_compiler,
         }
     }
 
-    bool pch_updated = false;
+    uint64_t pch_state = 0;     // fingerprint of precompiled header - part of the fingerprint of every source using it
+    bool pch_compiled  = false; // sources have to be compiled again with the new precompiled header
     if (!pch.empty()) {
         const auto* compiler    = have_cpp_files ? cpp_compiler.get() : c_compiler.get();
         const auto pch_name     = have_cpp_files ? "pch.hpp" : "pch.h";
@@ -485,26 +484,26 @@ void Component::configure(std::shared_ptr<Compiler> c_compiler,
             std::ofstream gen_src_file(gen_src_path);
             gen_src_file << gen_src.rdbuf();
             gen_src_file.close();
-            pch_updated = true;
         }
 
+        // rewritten generated source has a new modified time - no need to force the compile
         SourceFilePath sfp(gen_src_path, false, output_dir, true);
-        const bool added = process_source_file_path(sfp, c_compiler, cpp_compiler, asm_compiler, need_update_pch);
-        if (added)
-            pch_updated = true;
+        pch_compiled = process_source_file_path(sfp, c_compiler, cpp_compiler, asm_compiler, 0, false, &pch_state);
 
         // Add pch flag
         // TODO: proper compiler check
         if ((compiler->get_type() == Compiler::Type::GNU) || (compiler->get_type() == Compiler::Type::CLANG))
-            m_compile_options.emplace_back(Visibility::PRIVATE, "-Winvalid-pch");
-        m_compile_options.emplace_back(Visibility::PRIVATE, compiler->get_pch_include_flags(gen_src_path));
+            m_pch_compile_options.emplace_back("-Winvalid-pch");
+        m_pch_compile_options.emplace_back(compiler->get_pch_include_flags(gen_src_path));
     }
 
     // iterate all sources
     std::for_each(std::execution::par, source_file_paths.begin(), source_file_paths.end(), [&](const SourceFilePath& e) {
-        process_source_file_path(e, c_compiler, cpp_compiler, asm_compiler, pch_updated);
+        process_source_file_path(e, c_compiler, cpp_compiler, asm_compiler, pch_state, pch_compiled);
     });
 
+    m_on_compile_entry = {};
+
     const auto configure_t2 = std::chrono::high_resolution_clock::now();
     auto configure_ms       = std::chrono::duration_cast<std::chrono::milliseconds>(configure_t2 - configure_t1).count();
     Log.trace("Configure done in {:.3}s", configure_ms / 1000.0f);
@@ -517,6 +516,8 @@ void Component::clean() {
     if (!std::filesystem::exists(get_local_output_directory()))
         return;
 
+    m_build_database.clear();
+
     // recursively remove all temp files from get_local_output_directory()
     for (const auto& entry : std::filesystem::recursive_directory_iterator(get_local_output_directory())) {
         if (std::find(s_TempFileExtensions.begin(), s_TempFileExtensions.end(), entry.path().extension()) != s_TempFileExtensions.end()) {
@@ -535,8 +536,8 @@ void Component::clean() {
     Log.trace("Clean done in {:.3}s", clean_ms / 1000.0f);
 }
 
-static std::pair<int, std::string> s_compile(const std::unique_ptr<CompileEntry>& ce) {
-    return execute_with_args(ce->compiler->get_location(), ce->compile_args);
+static std::pair<int, std::string> s_compile(const CompileEntry& ce) {
+    return execute_with_args(ce.compiler->get_executable_path(), ce.compile_args);
 }
 
 void Component::iterate_libs(const Component* comp, std::vector<std::string>& list) {
@@ -558,7 +559,126 @@ extern int e_total_project_source_count;
 extern int e_current_abs_source_index;
 std::mutex s_source_index_mutex;
 
-void Component::build() {
+// State of dependencies listed in dependency file of compiled source
+// Files changed after compile_start are recorded as missing - the object may have been compiled from an older version
+static std::vector<std::pair<std::string, BuildDatabase::FileState>> get_compiled_dependencies(const SourceEntry& source_entry,
+                                                                                              BuildDatabase::Time compile_start) {
+    std::vector<std::pair<std::string, BuildDatabase::FileState>> dependencies;
+
+    const auto* compiler = source_entry.get_compiler();
+    const auto dep_path =
+        source_entry.get_output_directory() /
+        (source_entry.get_source_file_path().filename().string() + compiler->get_dependency_extension());
+
+    compiler->iterate_dependency_file(dep_path, source_entry.get_source_file_path(), [&](std::string_view path) -> bool {
+        const auto modified_time = get_file_modified_time(path);
+        if (modified_time == std::filesystem::file_time_type::min())
+            return false; // not a file path
+        if (modified_time > compile_start) {
+            dependencies.emplace_back(path, BuildDatabase::FileState{std::filesystem::file_time_type::min()});
+        } else {
+            dependencies.emplace_back(path, BuildDatabase::FileState{modified_time, get_file_content_hash(path)});
+        }
+        return false;
+    });
+
+    return dependencies;
+}
+
+bool Component::compile(const CompileEntry& compile_entry) {
+    const auto t_start = std::chrono::high_resolution_clock::now();
+
+    const auto& source_entry = *compile_entry.source_entry;
+    const auto compile_start = std::filesystem::file_time_type::clock::now();
+    const auto source_stat                      = FileStatCache::stat(source_entry.get_source_file_path().string());
+    const BuildDatabase::FileState source_state = {
+        source_stat.modified_time,
+        get_current_file_content_hash(source_entry.get_source_file_path().string(), source_stat),
+    };
+
+    const auto [ret, msg] = s_compile(compile_entry);
+
+    const bool success  = ret == 0;
+    bool object_changed = true; // compiled object differs from the object of the last compile
+    if (success && source_stat.exists) {
+        const auto object_path = source_entry.get_object_path().string();
+
+        // precompiled header is not archived/linked - sources using it are compiled again and compared
+        uint64_t output_hash = 0;
+        if (source_entry.is_pch()) {
+            object_changed = false;
+        } else {
+            output_hash    = ObjectHash::get(source_entry.get_object_path(), GlobalConfig::ignore_debug_changes());
+            object_changed = !output_hash || output_hash != m_build_database.get_output_hash(object_path);
+            if (!object_changed)
+                Log.trace("[{}] {} unchanged", get_name(), source_entry.get_object_path().filename());
+        }
+
+        m_build_database.record(
+            object_path, compile_entry.fingerprint, source_state, get_compiled_dependencies(source_entry, compile_start), output_hash);
+    } else {
+        m_build_database.remove(source_entry.get_object_path().string());
+    }
+
+    if (!success) {
+        // do not leave a partially written object that looks up to date
+        std::error_code ec;
+        std::filesystem::remove(compile_entry.source_entry->get_object_path(), ec);
+
+        // killed because another job failed
+        if (ProcessSupervisor::is_terminating()) {
+            Log.trace("[{}] Cancelled {}", get_name(), compile_entry.source_entry->get_source_file_path());
+            return false;
+        }
+    }
+
+    const auto t_end           = std::chrono::high_resolution_clock::now();
+    const auto compile_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count();
+
+    // show full source path on fail and only filename on success
+    const auto compile_unit_path = success ? compile_entry.source_entry->get_source_file_path().filename().string() :
+                                             compile_entry.source_entry->get_source_file_path().string();
+
+    s_source_index_mutex.lock();
+    auto si = e_current_abs_source_index++;
+    Log.info("[{}{}/{} ({}%) {:.03f}s{}] ({}{}{}) {} {}{}{}{}" ANSI_RESET,
+             success ? ANSI_GREEN : ANSI_RED,
+             si,
+             e_total_project_source_count,
+             (int)(100.0f / e_total_project_source_count * si),
+             compile_time_ms / 1000.0f,
+             ANSI_RESET,
+             ANSI_LIGHT_GRAY,
+             get_name(),
+             ANSI_RESET,
+             success ? (ANSI_GRAY "Compiled" ANSI_GRAY) : (ANSI_RED "Failed to compile" ANSI_RESET),
+             ANSI_GRAY,
+             compile_unit_path,
+             msg.empty() ? (ANSI_RESET "") : (ANSI_RESET "\n"),
+             msg);
+
+    if (success && object_changed) {
+        set_did_build();
+    }
+    s_source_index_mutex.unlock();
+
+    return success;
+}
+
+// 0 if the file does not exist
+static uint64_t read_link_fingerprint(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::string value;
+    file >> value;
+    return std::strtoull(value.c_str(), nullptr, 16);
+}
+
+static void write_link_fingerprint(const std::filesystem::path& path, uint64_t fingerprint) {
+    std::ofstream file(path, std::ios::trunc);
+    file << std::hex << fingerprint << "\n";
+}
+
+void Component::finalize() {
     const auto build_t1 = std::chrono::high_resolution_clock::now();
 
     bool lib_was_built = false;
@@ -570,185 +690,32 @@ void Component::build() {
     }
 
     // return if have final build object and configure did not request source build
+    // executables are checked below - they are linked again if their link fingerprint changed
     if (get_type() == Type::LIBRARY) {
         if (!lib_was_built) {
             const auto library_path = get_local_output_directory() / (get_name() + std::string(m_archiver->get_archive_extension()));
             if (std::filesystem::exists(library_path)) {
-                if (get_compile_entries().empty())
+                // nothing compiled or all compiled objects are the same as before
+                if (!did_build() && !m_force_finalize) {
+                    if (!get_compile_entries().empty())
+                        Log.trace("[{}] Objects unchanged - skip archive", get_name());
                     return;
+                }
             }
         }
         // mark self as built
         set_did_build();
-    } else {
-            // check if a library was built. If so, dont allow skip (for linking)
-            if (!lib_was_built) {
-            const auto exe_path = get_local_output_directory() / (get_name() + std::string(m_linker->get_executable_extension()));
-            if (std::filesystem::exists(exe_path)) {
-                if (get_compile_entries().empty())
-                    return;
-            }
-        }
-    }
-
-    const auto& compile_entries = get_compile_entries();
-
-    if (!compile_entries.empty()) {
-        Log.trace("Build [{}]", get_name());
-
-        bool error_reported = false; // a source has reported a failed compilation
-
-        const auto compile = [&](const std::unique_ptr<CompileEntry>& compile_entry) {
-            if (error_reported)
-                return;
-            const auto t_start = std::chrono::high_resolution_clock::now();
-
-            const auto [ret, msg] = s_compile(compile_entry);
-
-            // don't show successful outputs from commands after the first failed one
-            const bool success = ret == 0;
-            if (success && error_reported)
-                return;
-
-            const auto t_end           = std::chrono::high_resolution_clock::now();
-            const auto compile_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count();
-
-            // show full source path on fail and only filename on success
-            const auto compile_unit_path = success ? compile_entry->source_entry->get_source_file_path().filename().string() :
-                                                     compile_entry->source_entry->get_source_file_path().string();
-
-            s_source_index_mutex.lock();
-            auto si = e_current_abs_source_index++;
-            Log.info("[{}{}/{} ({}%) {:.03f}s{}] ({}{}{}) {} {}{}{}{}" ANSI_RESET,
-                     success ? ANSI_GREEN : ANSI_RED,
-                     si,
-                     e_total_project_source_count,
-                     (int)(100.0f / e_total_project_source_count * si),
-                     compile_time_ms / 1000.0f,
-                     ANSI_RESET,
-                     ANSI_LIGHT_GRAY,
-                     get_name(),
-                     ANSI_RESET,
-                     success ? (ANSI_GRAY "Compiled" ANSI_GRAY) : (ANSI_RED "Failed to compile" ANSI_RESET),
-                     ANSI_GRAY,
-                     compile_unit_path,
-                     msg.empty() ? (ANSI_RESET "") : (ANSI_RESET "\n"),
-                     msg);
-
-            if (success) {
-                set_did_build();
-            }
-            s_source_index_mutex.unlock();
-
-            // if (!success) {
-            //     std::string cmd;
-            //     for (auto& flag : compile_entry->compile_args)
-            //         cmd += flag + " ";
-            //     Log.critical("command: {}", cmd);
-            // }
-
-            if (!success) {
-                error_reported = true;
-            }
-        };
-
-        if (GlobalConfig::number_of_worker_threads() > 1) {
-            const bool have_pch = compile_entries[0]->source_entry->is_pch();
-
-            if (have_pch)
-                compile(compile_entries[0]);
-
-            if (!error_reported) {
-                static constexpr bool USE_PARALLEL_EXEC = true;
-
-                if (USE_PARALLEL_EXEC) {
-                    std::for_each(std::execution::par_unseq,
-                                  have_pch ? (compile_entries.begin() + 1) : compile_entries.begin(),
-                                  compile_entries.end(),
-                                  compile);
-                } else {
-                    auto workers          = FunctionWorker::create_workers(GlobalConfig::number_of_worker_threads());
-                    auto compile_threaded = [&](const std::unique_ptr<CompileEntry>& ce) {
-                        while (1 < 2) {
-                            for (auto& w : workers) {
-                                if (!w->is_busy()) {
-                                    w->execute([&]() {
-                                        compile(ce);
-                                    });
-                                    return;
-                                }
-                                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                            }
-                        }
-                    };
-
-                    std::for_each(
-                        have_pch ? (compile_entries.begin() + 1) : compile_entries.begin(), compile_entries.end(), compile_threaded);
-                    for (auto& w : workers) {
-                        while (w->is_busy()) {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                        }
-                        w->terminate();
-                    }
-                }
-            }
-        } else {
-            std::for_each(std::execution::seq, compile_entries.begin(), compile_entries.end(), compile);
-        }
-
-        if (error_reported) {
-            throw std::runtime_error("Compilation failed");
-        }
     }
 
     // Linking
     std::vector<std::filesystem::path> obj_paths;
+    std::filesystem::path link_fingerprint_file; // written after successful link and after-build commands
+    uint64_t link_fingerprint = 0;
 
     if (get_type() == Type::LIBRARY) {
         Log.trace("Archive [{}]", get_name());
-        // Create link command and execute to link all compile_entries object files into library file
-        std::vector<std::string> ar_flags;
-        const auto arch_out_path = get_local_output_directory() / (get_name() + m_archiver->get_archive_extension());
-
-        // delete archive if exists
-        if (std::filesystem::exists(arch_out_path)) {
-            std::filesystem::remove(arch_out_path);
-        }
-
-        m_archiver->load_archive_flags(ar_flags, arch_out_path);
-        for (const auto& obj : get_output_object_paths()) {
-            obj_paths.push_back(std::filesystem::weakly_canonical(obj));
-        }
-        const auto arg_file = get_local_output_directory() / (get_name() + "_ar_args.txt");
-        // delete arg_file
-        if (std::filesystem::exists(arg_file)) {
-            std::filesystem::remove(arg_file);
-        }
-        // write cmd_entries line by line to arg file
-        std::ofstream stream_arg_file(arg_file);
-        for (const auto& ce : obj_paths) {
-            stream_arg_file << FilesystemUtils::safe_path_string(ce.string()) << " ";
-        }
-        stream_arg_file.close();
-        if (!arg_file.empty())
-            m_archiver->load_input_flag_extension_file(ar_flags, arg_file);
-
-        const auto [ret, msg] = execute_with_args(m_archiver->get_location(), ar_flags);
-        if (ret != 0) {
-            Log.error("Failed to archive [{}]:\n{}", get_name(), msg);
-            // print archive command
-            std::string arstr;
-            for (auto& a : ar_flags) {
-                arstr += a + " ";
-            }
-            Log.error("Command: {}", arstr);
-
-            throw std::runtime_error("Failed to archive");
-        }
+        archive(get_local_output_directory() / (get_name() + m_archiver->get_archive_extension()));
     } else {
-        Log.info("Link [{}]", get_name());
-        const auto t1 = std::chrono::high_resolution_clock::now();
-
         // recursively iterate all libraries of get_libraries() and add .a paths to vector
         std::vector<std::string> library_paths;
         iterate_libs(this, library_paths);
@@ -772,16 +739,13 @@ void Component::build() {
         }
 
         const auto out_file = get_local_output_directory() / (get_name() + std::string(m_linker->get_executable_extension()));
-        // delete out_file if exists
-        if (std::filesystem::exists(out_file)) {
-            std::filesystem::remove(out_file);
-        }
 
         m_linker->load_link_flags(link_flags, out_file, get_linker_script_path());
 
         for (const auto& obj : get_output_object_paths()) {
             obj_paths.push_back(std::filesystem::weakly_canonical(obj));
         }
+        std::sort(obj_paths.begin(), obj_paths.end()); // objects are added by parallel configure
 
         const auto arg_file = get_local_output_directory() / (get_name() + "_link_args.txt");
         // delete arg_file
@@ -808,8 +772,26 @@ void Component::build() {
             prepare_and_push_flags(link_flags, flag);
         }
 
-        const auto [ret, msg] = execute_with_args(m_linker->get_location(), link_flags);
+        // keep executable if nothing it is linked from changed
+        link_fingerprint_file = get_local_output_directory() / (get_name() + "_link_fingerprint.txt");
+        link_fingerprint      = get_link_fingerprint(link_flags);
+        if (std::filesystem::exists(out_file) && read_link_fingerprint(link_fingerprint_file) == link_fingerprint) {
+            if (did_build() || lib_was_built || m_force_finalize)
+                Log.info("[{}] Link inputs unchanged - skip link", get_name());
+            m_force_finalize = false;
+            return;
+        }
+        std::error_code fingerprint_ec;
+        std::filesystem::remove(link_fingerprint_file, fingerprint_ec);
+
+        Log.info("Link [{}]", get_name());
+        const auto t1 = std::chrono::high_resolution_clock::now();
+
+        const auto [ret, msg] = execute_with_args(m_linker->get_executable_path(), link_flags);
         if (ret != 0) {
+            std::error_code ec;
+            std::filesystem::remove(out_file, ec);
+
             std::string lfstr;
             for (auto& a : link_flags) {
                 lfstr += a + " ";
@@ -843,9 +825,237 @@ void Component::build() {
         }
     }
 
+    if (!link_fingerprint_file.empty())
+        write_link_fingerprint(link_fingerprint_file, link_fingerprint);
+
+    m_force_finalize = false;
+
     const auto build_t2 = std::chrono::high_resolution_clock::now();
     auto build_ms       = std::chrono::duration_cast<std::chrono::milliseconds>(build_t2 - build_t1).count();
-    Log.trace("Build done in {:.3}s", build_ms / 1000.0f);
+    Log.trace("[{}] Finalize done in {:.3}s", get_name(), build_ms / 1000.0f);
+}
+
+uint64_t Component::get_object_hash(const std::filesystem::path& object_path) const {
+    const auto hash = m_build_database.get_output_hash(object_path.string());
+    return hash ? hash : ObjectHash::get(object_path, false); // object of an older version
+}
+
+uint64_t Component::get_objects_hash() const {
+    auto paths = get_output_object_paths();
+    std::sort(paths.begin(), paths.end());
+
+    uint64_t hash = HashUtils::FNV1A_OFFSET_BASIS;
+    for (const auto& path : paths) {
+        hash = HashUtils::fnv1a_field(path.string(), hash);
+        hash = HashUtils::fnv1a_field(std::to_string(get_object_hash(path)), hash);
+    }
+    return hash;
+}
+
+/// Libraries linked by component (libraries of libraries are linked too)
+static void collect_libraries(const Component* comp, std::vector<const Component*>& libraries) {
+    for (const auto* lib : comp->get_libraries()) {
+        if (std::find(libraries.begin(), libraries.end(), lib) != libraries.end())
+            continue;
+        libraries.push_back(lib);
+        collect_libraries(lib, libraries);
+    }
+}
+
+uint64_t Component::get_link_fingerprint(const std::vector<std::string>& link_flags) const {
+    uint64_t fingerprint = HashUtils::fnv1a_field(m_linker->get_executable_path());
+    fingerprint          = HashUtils::fnv1a_field(m_linker->get_version_string(), fingerprint);
+    for (const auto& flag : link_flags) {
+        fingerprint = HashUtils::fnv1a_field(flag, fingerprint);
+    }
+
+    // object list is passed in an argument file
+    fingerprint = HashUtils::fnv1a_field(std::to_string(get_objects_hash()), fingerprint);
+
+    // archives of the project are fingerprinted by their objects - thin archives do not change if an object changes
+    std::vector<const Component*> libraries;
+    collect_libraries(this, libraries);
+    for (const auto* lib : libraries) {
+        fingerprint = HashUtils::fnv1a_field(lib->get_name(), fingerprint);
+        fingerprint = HashUtils::fnv1a_field(std::to_string(lib->get_objects_hash()), fingerprint);
+        // prebuilt libraries are not hashed - they are replaced, not rebuilt in place
+        for (const auto& path : lib->get_additional_libraries()) {
+            const auto stat = FileStatCache::stat(path);
+            fingerprint     = HashUtils::fnv1a_field(path, fingerprint);
+            fingerprint     = HashUtils::fnv1a_field(std::to_string(stat.size), fingerprint);
+            fingerprint     = HashUtils::fnv1a_field(std::to_string(stat.modified_time.time_since_epoch().count()), fingerprint);
+        }
+    }
+
+    if (!get_linker_script_path().empty()) {
+        const MappedFile linker_script(get_linker_script_path());
+        const auto hash = linker_script.is_open() ? ContentHashCache::hash(linker_script.view()) : 0;
+        fingerprint     = HashUtils::fnv1a_field(std::to_string(hash), fingerprint);
+    }
+
+    // after-build commands run again if they changed
+    const auto commands = m_commands.find("after-build");
+    if (commands != m_commands.end()) {
+        for (const auto& command : commands->second) {
+            fingerprint = HashUtils::fnv1a_field(command.name, fingerprint);
+            for (const auto& arg : command.list) {
+                fingerprint = HashUtils::fnv1a_field(arg, fingerprint);
+            }
+        }
+    }
+
+    return fingerprint;
+}
+
+// object path -> output hash of the object when it was added to the archive
+using ArchiveMembers = std::unordered_map<std::string, uint64_t>;
+
+/// Read members file ("<hash> <object path>" per line) - return false if it does not exist or is invalid
+static bool load_archive_members(const std::filesystem::path& path, ArchiveMembers& members) {
+    std::ifstream file(path);
+    if (!file.is_open())
+        return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        const auto separator = line.find(' ');
+        if (separator == std::string::npos)
+            return false;
+        members[line.substr(separator + 1)] = std::strtoull(line.c_str(), nullptr, 16);
+    }
+    return true;
+}
+
+static void save_archive_members(const std::filesystem::path& path, const ArchiveMembers& members) {
+    std::ofstream file(path, std::ios::trunc);
+    for (const auto& [object_path, hash] : members) {
+        file << std::hex << hash << " " << object_path << "\n";
+    }
+}
+
+/// Write arguments to command line extension file
+static void write_arg_file(const std::filesystem::path& path, const std::vector<std::string>& args) {
+    std::ofstream stream_arg_file(path, std::ios::trunc);
+    for (const auto& arg : args) {
+        stream_arg_file << FilesystemUtils::safe_path_string(arg) << " ";
+    }
+}
+
+void Component::archive(const std::filesystem::path& archive_path) {
+    // objects that were added to the archive with their output hashes (archive is created again if unknown)
+    const auto members_path = get_local_output_directory() / (get_name() + "_ar_members.txt");
+    const auto arg_file     = get_local_output_directory() / (get_name() + "_ar_args.txt");
+
+    // members are matched by file name - objects of sources with the same name in different directories can not be updated
+    ArchiveMembers current;
+    std::unordered_set<std::string> member_names;
+    bool unique_member_names = true;
+    for (const auto& obj : get_output_object_paths()) {
+        const auto path = std::filesystem::weakly_canonical(obj);
+        current[path.string()] = m_build_database.get_output_hash(obj.string());
+        if (!member_names.insert(path.filename().string()).second)
+            unique_member_names = false;
+    }
+
+    // thin archive only references objects - it is always written again
+    const bool thin = is_thin_archive() && m_archiver->supports_thin_archives();
+    if (is_thin_archive() && !thin)
+        Log.warn("[{}] Archiver does not support thin archives - creating full archive", get_name());
+
+    ArchiveMembers archived;
+    const bool update = !thin && m_archiver->supports_incremental_update() && unique_member_names &&
+                        std::filesystem::exists(archive_path) && load_archive_members(members_path, archived);
+
+    // written again when the archive is complete - an interrupted update is followed by a full archive
+    std::error_code ec;
+    std::filesystem::remove(members_path, ec);
+
+    const auto run_archiver = [&](const std::vector<std::string>& ar_flags) {
+        const auto [ret, msg] = execute_with_args(m_archiver->get_executable_path(), ar_flags);
+        if (ret != 0) {
+            std::filesystem::remove(archive_path, ec);
+
+            Log.error("Failed to archive [{}]:\n{}", get_name(), msg);
+            // print archive command
+            std::string arstr;
+            for (auto& a : ar_flags) {
+                arstr += a + " ";
+            }
+            Log.error("Command: {}", arstr);
+
+            throw std::runtime_error("Failed to archive");
+        }
+    };
+
+    if (update) {
+        // replace changed objects and delete objects of removed sources - symbol index is written by the last command
+        std::vector<std::string> replaced;
+        std::vector<std::string> removed;
+        for (const auto& [path, hash] : current) {
+            const auto it = archived.find(path);
+            if (!hash || it == archived.end() || it->second != hash)
+                replaced.push_back(path);
+        }
+        for (const auto& [path, hash] : archived) {
+            if (!current.contains(path))
+                removed.push_back(std::filesystem::path(path).filename().string());
+        }
+        std::sort(replaced.begin(), replaced.end());
+        std::sort(removed.begin(), removed.end());
+
+        if (!removed.empty()) {
+            const auto delete_arg_file = get_local_output_directory() / (get_name() + "_ar_delete_args.txt");
+            std::vector<std::string> ar_flags;
+            m_archiver->load_delete_flags(ar_flags, archive_path, replaced.empty());
+            write_arg_file(delete_arg_file, removed);
+            m_archiver->load_input_flag_extension_file(ar_flags, delete_arg_file);
+            run_archiver(ar_flags);
+        }
+        if (!replaced.empty()) {
+            std::vector<std::string> ar_flags;
+            m_archiver->load_update_flags(ar_flags, archive_path, true);
+            write_arg_file(arg_file, replaced);
+            m_archiver->load_input_flag_extension_file(ar_flags, arg_file);
+            run_archiver(ar_flags);
+        }
+        Log.trace("[{}] Updated archive - {} replaced, {} removed", get_name(), replaced.size(), removed.size());
+    } else {
+        // delete archive if exists
+        if (std::filesystem::exists(archive_path)) {
+            std::filesystem::remove(archive_path);
+        }
+
+        std::vector<std::string> obj_paths;
+        for (const auto& [path, hash] : current) {
+            obj_paths.push_back(path);
+        }
+        std::sort(obj_paths.begin(), obj_paths.end());
+
+        std::vector<std::string> ar_flags;
+        m_archiver->load_archive_flags(ar_flags, archive_path, thin);
+        write_arg_file(arg_file, obj_paths);
+        m_archiver->load_input_flag_extension_file(ar_flags, arg_file);
+        run_archiver(ar_flags);
+    }
+
+    if (unique_member_names && !thin)
+        save_archive_members(members_path, current);
+}
+
+std::vector<std::filesystem::path> Component::get_input_paths() const {
+    std::vector<std::filesystem::path> paths;
+    if (m_source_file_paths) {
+        for (const auto& sfp : *m_source_file_paths) {
+            paths.push_back(sfp.path);
+        }
+    }
+    // headers found in dependency files of the last compiles
+    for (const auto& path : m_build_database.get_dependency_paths()) {
+        paths.emplace_back(path);
+    }
+    if (!m_linker_script_path.empty())
+        paths.push_back(m_linker_script_path.is_relative() ? get_root_path() / m_linker_script_path : m_linker_script_path);
+    return paths;
 }
 
 std::vector<Component::SourceFilePath> Component::get_source_file_paths() {
@@ -1135,6 +1345,23 @@ void Component::lua_set_linker_script(lua_State* L) {
     }
 }
 
+void Component::lua_set_thin_archive(lua_State* L) {
+    const auto arg_enabled = luabridge::LuaRef::fromStack(L, LUA_FUNCTION_ARG_COMPONENT_OFFSET(0));
+    if (get_type() != Type::LIBRARY) {
+        luaL_error(L, "Thin archive can only be set for libraries [%s]", get_name().c_str());
+        throw std::runtime_error("Thin archive set for executable");
+    }
+    if (arg_enabled.type() != LUA_TBOOLEAN) {
+        luaL_error(L,
+                   "Invalid thin archive argument: type \"%s\"\n%s",
+                   lua_typename(L, arg_enabled.type()),
+                   LuaBackend::get_script_help_string(LuaBackend::HelpEntry::COMPONENT_SET_THIN_ARCHIVE));
+        throw std::runtime_error("Invalid thin archive argument");
+    }
+
+    set_thin_archive(arg_enabled.cast<bool>());
+}
+
 void Component::lua_add_libraries(lua_State* L) {
     auto arg_libs = luabridge::LuaRef::fromStack(L, LUA_FUNCTION_ARG_COMPONENT_OFFSET(0));
 
@@ -1241,9 +1468,133 @@ void Component::add_user(Component* user) {
     m_used_by.push_back(user);
 }
 
+template<typename T>
+static void write_scoped_values(BuildPlan::Writer& writer, const std::vector<Component::ScopedValue<T>>& values) {
+    writer.write((uint32_t)values.size());
+    for (const auto& val : values) {
+        writer.write(val.visibility);
+        writer.write(val.value);
+    }
+}
+
+template<typename T>
+static void read_scoped_values(BuildPlan::Reader& reader, std::vector<Component::ScopedValue<T>>& values) {
+    uint32_t count = 0;
+    reader.read(count);
+    for (uint32_t i = 0; i < count && !reader.failed(); i++) {
+        auto& val = values.emplace_back();
+        reader.read(val.visibility);
+        reader.read(val.value);
+    }
+}
+
+void Component::write_plan(BuildPlan::Writer& writer) const {
+    writer.write(m_type);
+    writer.write(m_name);
+    writer.write(m_script_path);
+    writer.write(m_root_path);
+    writer.write(m_local_output_directory);
+    writer.write(m_namespace);
+
+    writer.write((uint32_t)m_commands.size());
+    for (const auto& [type, commands] : m_commands) {
+        writer.write(type);
+        writer.write((uint32_t)commands.size());
+        for (const auto& command : commands) {
+            writer.write(command.name);
+            writer.write(command.list);
+        }
+    }
+
+    writer.write(m_requested_sources);
+    writer.write(m_requested_source_filters);
+    writer.write(m_precompiled_header);
+
+    write_scoped_values(writer, m_include_paths);
+    write_scoped_values(writer, m_definitions);
+    write_scoped_values(writer, m_compile_options);
+    writer.write(m_visibility_mask_include_paths);
+    writer.write(m_visibility_mask_definitions);
+    writer.write(m_visibility_mask_compile_options);
+
+    writer.write((uint32_t)m_compile_option_replacements.size());
+    for (const auto& replacement : m_compile_option_replacements) {
+        writer.write(replacement.match);
+        writer.write(replacement.search);
+        writer.write(replacement.replace);
+    }
+
+    writer.write(m_linker_script_path);
+    writer.write(m_link_options);
+    writer.write(m_additional_libraries);
+    writer.write(m_thin_archive);
+}
+
+std::shared_ptr<Component> Component::read_plan(BuildPlan::Reader& reader) {
+    Type type;
+    std::string name;
+    std::filesystem::path script_path;
+    std::filesystem::path root_path;
+    std::filesystem::path local_output_directory;
+    std::string ns;
+    reader.read(type);
+    reader.read(name);
+    reader.read(script_path);
+    reader.read(root_path);
+    reader.read(local_output_directory);
+    reader.read(ns);
+    if (reader.failed())
+        return nullptr;
+
+    auto comp = std::make_shared<Component>(type, name, script_path, root_path, local_output_directory, ns);
+
+    uint32_t command_type_count = 0;
+    reader.read(command_type_count);
+    for (uint32_t i = 0; i < command_type_count && !reader.failed(); i++) {
+        std::string command_type;
+        uint32_t command_count = 0;
+        reader.read(command_type);
+        reader.read(command_count);
+        auto& commands = comp->m_commands[command_type];
+        for (uint32_t j = 0; j < command_count && !reader.failed(); j++) {
+            auto& command = commands.emplace_back();
+            reader.read(command.name);
+            reader.read(command.list);
+        }
+    }
+
+    reader.read(comp->m_requested_sources);
+    reader.read(comp->m_requested_source_filters);
+    reader.read(comp->m_precompiled_header);
+
+    read_scoped_values(reader, comp->m_include_paths);
+    read_scoped_values(reader, comp->m_definitions);
+    read_scoped_values(reader, comp->m_compile_options);
+    reader.read(comp->m_visibility_mask_include_paths);
+    reader.read(comp->m_visibility_mask_definitions);
+    reader.read(comp->m_visibility_mask_compile_options);
+
+    uint32_t replacement_count = 0;
+    reader.read(replacement_count);
+    for (uint32_t i = 0; i < replacement_count && !reader.failed(); i++) {
+        auto& replacement = comp->m_compile_option_replacements.emplace_back();
+        reader.read(replacement.match);
+        reader.read(replacement.search);
+        reader.read(replacement.replace);
+    }
+
+    reader.read(comp->m_linker_script_path);
+    reader.read(comp->m_link_options);
+    reader.read(comp->m_additional_libraries);
+    reader.read(comp->m_thin_archive);
+
+    return reader.failed() ? nullptr : comp;
+}
+
 luabridge::LuaRef Component::lua_get_git_info(lua_State* L) {
     GIT git(get_root_path());
     if (!git.is_git_repository()) {
+        BuildPlan::record_input(BuildPlan::InputType::GIT_INFO, get_root_path().string(), "");
         luaL_error(L, "Not a git repository");
     }
 
@@ -1251,6 +1602,9 @@ luabridge::LuaRef Component::lua_get_git_info(lua_State* L) {
     luabridge::LuaRef git_info = luabridge::newTable(L);
     git_info["branch"]         = git.get_current_branch();
     git_info["short_hash"]     = git.get_current_short_hash();
+    BuildPlan::record_input(BuildPlan::InputType::GIT_INFO,
+                            get_root_path().string(),
+                            git.get_current_branch() + "\n" + git.get_current_short_hash());
     return git_info;
 }
 
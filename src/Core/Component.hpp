@@ -1,7 +1,11 @@
 #pragma once
 #include <filesystem>
+#include <functional>
+#include <optional>
 #include <string>
 #include "Core/Archiver.hpp"
+#include "Core/BuildPlan.hpp"
+#include "BuildDatabase.hpp"
 #include "SourceEntry.hpp"
 #include "Compiler.hpp"
 #include "Linker.hpp"
@@ -73,6 +77,7 @@ public:
     void lua_add_definitions(lua_State* L);
     void lua_add_compile_options(lua_State* L);
     void lua_set_linker_script(lua_State* L);
+    void lua_set_thin_archive(lua_State* L);
     void lua_add_libraries(lua_State* L);
     void lua_add_link_options(lua_State* L);
     void lua_create_precompiled_header(lua_State* L);
@@ -82,14 +87,23 @@ public:
     std::string lua_get_output_path();
     std::string lua_get_name();
 
+    /// on_compile_entry - called for every compile entry as soon as it is created (from multiple threads)
     void configure(std::shared_ptr<Compiler> c_compiler,
                    std::shared_ptr<Compiler> cpp_compiler,
                    std::shared_ptr<Compiler> asm_compiler,
                    std::shared_ptr<Linker> linker,
-                   std::shared_ptr<Archiver> archiver);
-    void build();
+                   std::shared_ptr<Archiver> archiver,
+                   std::function<void(CompileEntry*)> on_compile_entry = {});
     void clean();
 
+    /// Compile a single compile entry of this component
+    /// Return true if compiled successfully
+    bool compile(const CompileEntry& compile_entry);
+
+    /// Archive/link compiled objects and run after-build commands
+    /// Called after all compile entries and libraries are done
+    void finalize();
+
     Type get_type() const { return m_type; }
     const std::string& get_name() const { return m_name; }
     const std::filesystem::path& get_script_path() const { return m_script_path; }
@@ -120,13 +134,36 @@ public:
 
     const std::vector<std::string>& get_additional_libraries() const { return m_additional_libraries; }
 
+    /// Archive references the objects in the output directory instead of containing copies
+    bool is_thin_archive() const { return m_thin_archive; }
+    void set_thin_archive(bool thin) { m_thin_archive = thin; }
+
     const std::string& get_namespace() const { return m_namespace; }
 
     const std::vector<CommandEntry>& get_commands(const std::string& type) { return m_commands[type]; }
 
+    /// Write compile state of objects for the next build
+    void save_build_database() { m_build_database.save(); }
+
+    /// An object changed or the component was archived - users of the library have to be linked again
     void set_did_build() { m_did_build = true; }
     bool did_build() const { return m_did_build; }
 
+    /// Search requested sources again on the next configure (files were added or removed)
+    void invalidate_source_file_paths() { m_rescan_source_file_paths = true; }
+
+    /// Archive/link on the next build even if no object was compiled
+    void force_finalize() { m_force_finalize = true; }
+
+    /// Get sources, dependencies of compiled objects and linker script - files that change the build output
+    std::vector<std::filesystem::path> get_input_paths() const;
+
+    /// Write everything the scripts set for this component to build plan (libraries are written by the project)
+    void write_plan(BuildPlan::Writer& writer) const;
+
+    /// Create component from build plan - return nullptr if plan content is invalid
+    static std::shared_ptr<Component> read_plan(BuildPlan::Reader& reader);
+
 private:
     /// Get vector of processed source file paths
     std::vector<SourceFilePath> get_source_file_paths();
@@ -135,15 +172,32 @@ private:
     std::filesystem::path get_source_output_directory(const SourceFilePath& sfp);
 
     /// Process source path and add to compile list if needed
+    /// pch_state - fingerprint of the precompiled header used by the source (0 if none)
+    /// force_compile - compile even if the object is up to date
+    /// fingerprint - set to the fingerprint of the compile command
     /// Return true if added to compile list
     bool process_source_file_path(const SourceFilePath& sfp,
                                   std::shared_ptr<Compiler> c_compiler,
                                   std::shared_ptr<Compiler> cpp_compiler,
                                   std::shared_ptr<Compiler> asm_compiler,
-                                  bool force_compile);
+                                  uint64_t pch_state,
+                                  bool force_compile,
+                                  uint64_t* fingerprint = nullptr);
 
     const std::vector<CompileOptionReplacement>& get_compile_option_replacements() const { return m_compile_option_replacements; }
 
+    /// Create archive of output objects or update changed members of the existing archive
+    void archive(const std::filesystem::path& archive_path);
+
+    /// Get output hash of object recorded at compile (hash of the file if unknown)
+    uint64_t get_object_hash(const std::filesystem::path& object_path) const;
+
+    /// Hash of paths and output hashes of all output objects
+    uint64_t get_objects_hash() const;
+
+    /// Hash of link command, objects, libraries, linker script and after-build commands
+    uint64_t get_link_fingerprint(const std::vector<std::string>& link_flags) const;
+
 private:
     static void iterate_libs(const Component* comp, std::vector<std::string>& list);
 
@@ -153,6 +207,7 @@ private:
     std::filesystem::path m_script_path;
     std::filesystem::path m_root_path;
     std::filesystem::path m_local_output_directory;
+    BuildDatabase m_build_database; // compile state of objects in output directory
 
     bool m_did_build = false;
 
@@ -171,6 +226,7 @@ private:
 
     // Compile
     std::vector<std::unique_ptr<CompileEntry>> m_compile_entries;
+    std::function<void(CompileEntry*)> m_on_compile_entry; // only set during configure
 
     std::vector<CompileOptionReplacement> m_compile_option_replacements;
 
@@ -178,6 +234,10 @@ private:
     std::vector<std::string> m_requested_sources;        // requested sources
     std::vector<std::string> m_requested_source_filters; // source filters
 
+    std::optional<std::vector<SourceFilePath>> m_source_file_paths; // result of get_source_file_paths() - kept between configures
+    bool m_rescan_source_file_paths = false;
+    bool m_force_finalize           = false; // archive/link even if no object was compiled (sources were removed)
+
     // Precompilled header
     std::vector<std::string> m_precompiled_header; // list of header paths to precompile
 
@@ -185,6 +245,7 @@ private:
     std::vector<ScopedValue<std::filesystem::path>> m_include_paths;
     std::vector<ScopedValue<std::string>> m_definitions;
     std::vector<ScopedValue<std::string>> m_compile_options;
+    std::vector<std::string> m_pch_compile_options; // added by configure for sources using the precompiled header
     Visibility m_visibility_mask_include_paths   = Visibility::NONE;
     Visibility m_visibility_mask_definitions     = Visibility::NONE;
     Visibility m_visibility_mask_compile_options = Visibility::NONE;
@@ -197,6 +258,7 @@ private:
     std::vector<std::filesystem::path> m_output_object_paths; // All compiled .o file paths related to this component
 
     std::vector<std::string> m_additional_libraries;
+    bool m_thin_archive = false;
 };
 
 inline const char* to_string(Component::Type type) {
@@ -0,0 +1,152 @@
+#include "ContentHashCache.hpp"
+#include <cstring>
+#include <fstream>
+#include <xxhash.h>
+#include "Core/BuildPlan.hpp"
+#include "Core/FileStatCache.hpp"
+#include "MappedFile.hpp"
+
+// file layout: magic, entry count, [path length, path, entry] * count
+static constexpr char FILE_MAGIC[8] = {'C', 'F', 'X', 'S', 'C', 'H', '0', '1'};
+
+ContentHashCache::ContentHashCache(const std::filesystem::path& path) : m_path(path) {}
+
+void ContentHashCache::load() {
+    const MappedFile file(m_path);
+    if (!file.is_open())
+        return;
+
+    BuildPlan::Reader reader(file.view());
+    char magic[sizeof(FILE_MAGIC)];
+    uint64_t count = 0;
+    reader.read(magic);
+    reader.read(count);
+    if (reader.failed() || std::memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        Log.warn("Ignoring invalid content hash file \"{}\"", m_path);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint64_t i = 0; i < count; i++) {
+        std::string path;
+        Entry entry;
+        reader.read(path);
+        reader.read(entry);
+        if (reader.failed()) {
+            Log.warn("Ignoring corrupted content hash file \"{}\"", m_path);
+            m_entries.clear();
+            return;
+        }
+        m_entries[std::move(path)] = entry;
+    }
+
+    Log.trace("Loaded {} content hashes", m_entries.size());
+}
+
+void ContentHashCache::save() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_modified)
+        return;
+
+    // hashes of files that were not used in this run are dropped
+    BuildPlan::Writer writer;
+    uint64_t count = 0;
+    for (const auto& [path, entry] : m_entries) {
+        if (m_used.contains(path))
+            count++;
+    }
+    writer.write(FILE_MAGIC);
+    writer.write(count);
+    for (const auto& [path, entry] : m_entries) {
+        if (!m_used.contains(path))
+            continue;
+        writer.write(path);
+        writer.write(entry);
+    }
+
+    // write to temporary file - a partially written file would be ignored and all hashes read again
+    auto temp_path = m_path;
+    temp_path += ".tmp";
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (file.is_open())
+        file.write(writer.get_data().data(), writer.get_data().size());
+    file.close();
+
+    std::error_code ec;
+    if (file)
+        std::filesystem::rename(temp_path, m_path, ec);
+    if (!file || ec) {
+        Log.warn("Failed to write content hash file \"{}\"", m_path);
+        std::filesystem::remove(temp_path, ec);
+        return;
+    }
+
+    m_modified = false;
+}
+
+uint64_t ContentHashCache::get(std::string_view path) {
+    std::string key(path);
+
+    std::promise<uint64_t> promise;
+    std::shared_future<uint64_t> future;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_requested.find(key);
+        if (it != m_requested.end()) {
+            future = it->second;
+        } else {
+            m_requested.emplace(key, promise.get_future().share());
+        }
+    }
+    if (future.valid())
+        return future.get();
+
+    const auto result = read_hash(key, FileStatCache::get(key));
+    promise.set_value(result);
+    return result;
+}
+
+uint64_t ContentHashCache::get_current(std::string_view path, const FileStatCache::Stat& stat) {
+    return read_hash(std::string(path), stat); //
+}
+
+void ContentHashCache::invalidate() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requested.clear();
+}
+
+uint64_t ContentHashCache::hash(std::string_view data) {
+    const uint64_t result = XXH3_64bits(data.data(), data.size());
+    return result ? result : 1; // 0 is "no hash"
+}
+
+uint64_t ContentHashCache::read_hash(const std::string& path, const FileStatCache::Stat& stat) {
+    if (!stat.exists)
+        return 0;
+    const auto size          = stat.size;
+    const auto modified_time = stat.modified_time.time_since_epoch().count();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_used.insert(path).second)
+            m_modified = true;
+        const auto it = m_entries.find(path);
+        if (it != m_entries.end() && it->second.size == size && it->second.modified_time == modified_time)
+            return it->second.hash;
+    }
+
+    const MappedFile file(path);
+    if (!file.is_open())
+        return 0;
+    const auto result = hash(file.view());
+
+    // file written while it was read - hash does not belong to stat
+    const auto current_stat = FileStatCache::stat(path);
+    if (current_stat.size != size || current_stat.modified_time != stat.modified_time)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[path] = {modified_time, size, result};
+    m_modified      = true;
+    return result;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include "Core/FileStatCache.hpp"
+
+/// Content hashes (XXH3) of sources and headers for --content-hash builds
+/// A file is only read again if its size or modified time changed since its hash was stored
+/// Every file is hashed at most once per run - threads requesting a file that is being hashed wait for the result
+/// Only hashes of files used by this run are saved
+class ContentHashCache {
+public:
+    ContentHashCache(const std::filesystem::path& path);
+
+    void load();
+    void save();
+
+    /// Get content hash of file, 0 if file can not be read
+    uint64_t get(std::string_view path);
+
+    /// Get content hash of file with the size and modified time of stat (not cached per run)
+    /// Returns 0 if the file can not be read or has changed since stat
+    uint64_t get_current(std::string_view path, const FileStatCache::Stat& stat);
+
+    /// Files changed - check them again when requested (--watch)
+    void invalidate();
+
+    /// Hash data (never 0)
+    static uint64_t hash(std::string_view data);
+
+private:
+    struct Entry {
+        int64_t modified_time;
+        uint64_t size;
+        uint64_t hash;
+    };
+
+    uint64_t read_hash(const std::string& path, const FileStatCache::Stat& stat);
+
+private:
+    std::filesystem::path m_path;
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;                          // stored hashes
+    std::unordered_map<std::string, std::shared_future<uint64_t>> m_requested; // hashes of this run
+    std::unordered_set<std::string> m_used;                                    // paths of stored hashes that are saved
+    bool m_modified = false;
+};
@@ -0,0 +1,166 @@
+#include "DependencyParser.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DEPENDENCY_PARSER_SSE2
+#endif
+
+namespace DependencyParser {
+
+    // bytes that end a path or need special handling - whitespace/control characters, escapes, rule separator, comments
+    static constexpr std::array<bool, 256> SPECIAL_CHARACTERS = []() {
+        std::array<bool, 256> table{};
+        for (int c = 0; c <= ' '; c++) {
+            table[c] = true;
+        }
+        table['\\'] = true;
+        table[':']  = true;
+        table['$']  = true;
+        table['#']  = true;
+        return table;
+    }();
+
+    static bool is_space(char c) { return (uint8_t)c <= ' '; }
+    static bool is_line_end(char c) { return c == '\n' || c == '\r'; }
+
+    /// Position of next special character at or after pos (size if none)
+    static size_t find_special(const char* data, size_t pos, size_t size) {
+#ifdef DEPENDENCY_PARSER_SSE2
+        // 16 bytes per iteration - most of a dependency file is plain path characters
+        const __m128i space     = _mm_set1_epi8(' ');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i colon     = _mm_set1_epi8(':');
+        const __m128i dollar    = _mm_set1_epi8('$');
+        const __m128i hash      = _mm_set1_epi8('#');
+        while (pos + 16 <= size) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            // unsigned chunk <= ' '
+            __m128i match = _mm_cmpeq_epi8(_mm_max_epu8(chunk, space), space);
+            match         = _mm_or_si128(match, _mm_cmpeq_epi8(chunk, backslash));
+            match         = _mm_or_si128(match, _mm_cmpeq_epi8(chunk, colon));
+            match         = _mm_or_si128(match, _mm_cmpeq_epi8(chunk, dollar));
+            match         = _mm_or_si128(match, _mm_cmpeq_epi8(chunk, hash));
+            const auto mask = (uint32_t)_mm_movemask_epi8(match);
+            if (mask)
+                return pos + std::countr_zero(mask);
+            pos += 16;
+        }
+#endif
+        while (pos < size && !SPECIAL_CHARACTERS[(uint8_t)data[pos]]) {
+            pos++;
+        }
+        return pos;
+    }
+
+    /// Skip "\n", "\r\n" or "\r" at pos
+    static size_t skip_line_end(const char* data, size_t pos, size_t size) {
+        if (pos < size && data[pos] == '\r')
+            pos++;
+        if (pos < size && data[pos] == '\n')
+            pos++;
+        return pos;
+    }
+
+    void parse_make(std::string_view content, const Callback& callback) {
+        const char* data  = content.data();
+        const size_t size = content.size();
+        size_t pos        = 0;
+        bool in_targets   = true; // before ':' of current rule
+        std::string unescaped;
+
+        while (pos < size) {
+            const char c = data[pos];
+
+            if (is_line_end(c)) {
+                in_targets = true; // next rule
+                pos++;
+                continue;
+            }
+            if (is_space(c)) {
+                pos++;
+                continue;
+            }
+            if (c == '\\' && pos + 1 < size && is_line_end(data[pos + 1])) {
+                pos = skip_line_end(data, pos + 1, size); // line continuation
+                continue;
+            }
+            if (c == '#') {
+                const auto* line_end = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+                pos                  = line_end ? line_end - data : size;
+                continue;
+            }
+            if (c == ':') {
+                in_targets = false; // rule separator ("::" rules too)
+                pos++;
+                continue;
+            }
+
+            // path - plain paths are passed as view of content, escaped paths are copied
+            size_t start = pos;
+            bool escaped = false;
+            unescaped.clear();
+            while (true) {
+                pos = find_special(data, pos, size);
+                if (pos >= size || is_space(data[pos]) || data[pos] == '#')
+                    break;
+
+                const char special = data[pos];
+                const char next    = pos + 1 < size ? data[pos + 1] : '\0';
+                if ((special == '\\' && (next == ' ' || next == '#')) || (special == '$' && next == '$')) {
+                    unescaped.append(data + start, pos - start);
+                    unescaped += next;
+                    pos += 2;
+                    start   = pos;
+                    escaped = true;
+                } else if (special == '\\' && is_line_end(next)) {
+                    break; // continuation after path without separating space
+                } else if (special == ':' && in_targets && (next == '\0' || is_space(next))) {
+                    break; // rule separator - "C:/path" and "C:\path" are paths
+                } else {
+                    pos++; // literal character ("\" of Windows paths, ":" of drive letters)
+                }
+            }
+
+            if (in_targets)
+                continue;
+
+            std::string_view path(data + start, pos - start);
+            if (escaped) {
+                unescaped.append(path);
+                path = unescaped;
+            }
+            if (!path.empty() && callback(path))
+                return;
+        }
+    }
+
+    void parse_lines(std::string_view content, const Callback& callback) {
+        const char* data  = content.data();
+        const size_t size = content.size();
+        size_t pos        = 0;
+
+        while (pos < size) {
+            const auto* line_end_ptr = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+            const size_t line_end    = line_end_ptr ? line_end_ptr - data : size;
+
+            size_t start = pos;
+            size_t end   = line_end;
+            while (start < end && is_space(data[start])) {
+                start++;
+            }
+            while (end > start && is_space(data[end - 1])) {
+                end--;
+            }
+
+            if (end > start && callback(std::string_view(data + start, end - start)))
+                return;
+
+            pos = line_end + 1;
+        }
+    }
+
+} // namespace DependencyParser
@@ -0,0 +1,20 @@
+#pragma once
+#include <functional>
+#include <string_view>
+
+/// Parsers for compiler generated dependency files
+/// Paths are passed as views into the file content - only paths containing escapes are copied
+/// Callbacks return true to stop parsing
+namespace DependencyParser {
+
+    using Callback = std::function<bool(std::string_view)>;
+
+    /// GNU make rules (gcc/clang -MD/-MMD/-MP)
+    /// "targets: prerequisites" with line continuations, escaped spaces and '#', "$$", comments and multiple rules
+    /// Only prerequisites are passed to callback - targets and phony rules without prerequisites produce nothing
+    void parse_make(std::string_view content, const Callback& callback);
+
+    /// One path per line (IAR --dependencies=i)
+    void parse_lines(std::string_view content, const Callback& callback);
+
+} // namespace DependencyParser
@@ -0,0 +1,94 @@
+#include "FileStatCache.hpp"
+#include <atomic>
+#include <string>
+#ifdef WINDOWS_BUILD
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <tbb/concurrent_unordered_map.h>
+#endif
+
+#ifdef WINDOWS_BUILD
+// no TBB on Windows builds
+static std::unordered_map<std::string, FileStatCache::Stat> s_stats;
+static std::shared_mutex s_mutex_stats;
+#else
+static tbb::concurrent_unordered_map<std::string, FileStatCache::Stat> s_stats;
+#endif
+
+static std::atomic<uint32_t> s_hit_count  = 0;
+static std::atomic<uint32_t> s_miss_count = 0;
+
+FileStatCache::Stat FileStatCache::stat(std::string_view path) {
+    Stat result = {false, std::filesystem::file_time_type::min(), 0};
+
+#ifdef WINDOWS_BUILD
+    std::error_code ec;
+    const auto status = std::filesystem::status(path, ec);
+    if (ec || !std::filesystem::exists(status))
+        return result;
+
+    result.exists        = true;
+    result.modified_time = std::filesystem::last_write_time(path, ec);
+    result.size          = std::filesystem::is_regular_file(status) ? std::filesystem::file_size(path, ec) : 0;
+    if (ec)
+        result.modified_time = std::filesystem::file_time_type::min();
+#else
+    // single syscall for all fields - std::filesystem needs one per field
+    const std::string path_str(path);
+    struct statx st;
+    if (statx(AT_FDCWD, path_str.c_str(), 0, STATX_MTIME | STATX_SIZE, &st) != 0)
+        return result;
+
+    const auto sys_time =
+        std::chrono::sys_seconds(std::chrono::seconds(st.stx_mtime.tv_sec)) + std::chrono::nanoseconds(st.stx_mtime.tv_nsec);
+    result.exists        = true;
+    result.modified_time = std::chrono::file_clock::from_sys(sys_time);
+    result.size          = st.stx_size;
+#endif
+
+    return result;
+}
+
+FileStatCache::Stat FileStatCache::get(std::string_view path) {
+#ifdef WINDOWS_BUILD
+    {
+        std::shared_lock lock(s_mutex_stats);
+        const auto it = s_stats.find(std::string(path));
+        if (it != s_stats.end()) {
+            s_hit_count++;
+            return it->second;
+        }
+    }
+
+    s_miss_count++;
+    const auto result = stat(path);
+    std::unique_lock lock(s_mutex_stats);
+    return s_stats.emplace(path, result).first->second;
+#else
+    std::string key(path);
+    const auto it = s_stats.find(key);
+    if (it != s_stats.end()) {
+        s_hit_count++;
+        return it->second;
+    }
+
+    // threads racing for the same path insert the same result
+    s_miss_count++;
+    const auto result = stat(path);
+    return s_stats.emplace(std::move(key), result).first->second;
+#endif
+}
+
+void FileStatCache::invalidate() {
+#ifdef WINDOWS_BUILD
+    std::unique_lock lock(s_mutex_stats);
+#endif
+    s_stats.clear();
+}
+
+uint32_t FileStatCache::get_hit_count() { return s_hit_count; }
+uint32_t FileStatCache::get_miss_count() { return s_miss_count; }
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+/// Existence, modified time and size of sources and headers for the whole run
+/// Keyed by the full path - every path is stat'ed once and lookups from multiple threads do not block each other
+class FileStatCache {
+public:
+    struct Stat {
+        bool exists;
+        std::filesystem::file_time_type modified_time; // file_time_type::min() if file does not exist
+        uint64_t size;
+    };
+
+public:
+    /// Get cached stat of path
+    static Stat get(std::string_view path);
+
+    /// Stat path without using the cache
+    static Stat stat(std::string_view path);
+
+    /// Forget all cached results (files changed) - not safe while other threads use the cache
+    static void invalidate();
+
+    static uint32_t get_hit_count();
+    static uint32_t get_miss_count();
+};
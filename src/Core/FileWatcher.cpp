@@ -0,0 +1,135 @@
+#include "FileWatcher.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#ifndef WINDOWS_BUILD
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef WINDOWS_BUILD
+
+FileWatcher::FileWatcher() {
+    Log.error("Watching files is not supported on Windows");
+    throw std::runtime_error("Watching files is not supported");
+}
+
+FileWatcher::~FileWatcher() {}
+
+void FileWatcher::add(const std::filesystem::path&) {}
+
+FileWatcher::Changes FileWatcher::wait(std::chrono::milliseconds) { return {}; }
+
+void FileWatcher::read_events(Changes&, std::unordered_set<std::string>&) {}
+
+#else
+
+// written/touched files, replaced files and directory entry changes - IN_MODIFY would report every write of a file
+static constexpr uint32_t WATCH_MASK =
+    IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+FileWatcher::FileWatcher() {
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        Log.error("Failed to initialize inotify: {}", strerror(errno));
+        throw std::runtime_error("Failed to initialize inotify");
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+void FileWatcher::add(const std::filesystem::path& path) {
+    std::error_code ec;
+    const auto full_path = std::filesystem::weakly_canonical(std::filesystem::absolute(path, ec), ec);
+    if (ec)
+        return;
+
+    // directory is watched again if it was removed and created again
+    m_files.insert(full_path.string());
+
+    const auto directory = full_path.parent_path().string();
+    if (m_directories.contains(directory) || m_limit_reached)
+        return;
+
+    const int wd = inotify_add_watch(m_fd, directory.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        if (errno == ENOSPC) {
+            Log.warn("inotify watch limit reached - some files are not watched (fs.inotify.max_user_watches)");
+            m_limit_reached = true;
+        } else {
+            Log.debug("Failed to watch \"{}\": {}", directory, strerror(errno));
+        }
+        return;
+    }
+
+    m_directories[directory] = wd;
+    m_descriptors[wd]        = directory;
+}
+
+void FileWatcher::read_events(Changes& changes, std::unordered_set<std::string>& seen) {
+    alignas(inotify_event) char buffer[16384];
+
+    while (true) {
+        const auto length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            return; // EAGAIN - no more events
+
+        for (ssize_t pos = 0; pos < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + pos);
+            pos += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_IGNORED) {
+                // directory was removed - watch it again if it is created again
+                const auto it = m_descriptors.find(event->wd);
+                if (it != m_descriptors.end()) {
+                    m_directories.erase(it->second);
+                    m_descriptors.erase(it);
+                }
+                continue;
+            }
+
+            const auto it = m_descriptors.find(event->wd);
+            if (it == m_descriptors.end() || !event->len || (event->mask & IN_ISDIR))
+                continue;
+
+            auto path = (std::filesystem::path(it->second) / event->name).string();
+            if (!seen.insert(path).second)
+                continue;
+
+            if (m_files.contains(path)) {
+                changes.modified.emplace_back(std::move(path));
+            } else if (event->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) {
+                changes.directory_entries.emplace_back(std::move(path));
+            } else {
+                seen.erase(path); // written file that is not watched
+            }
+        }
+    }
+}
+
+FileWatcher::Changes FileWatcher::wait(std::chrono::milliseconds settle_time) {
+    Changes changes;
+    std::unordered_set<std::string> seen;
+
+    pollfd pfd = {m_fd, POLLIN, 0};
+    while (true) {
+        const bool have_changes = !changes.modified.empty() || !changes.directory_entries.empty();
+        const int result        = poll(&pfd, 1, have_changes ? (int)settle_time.count() : -1);
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            Log.error("Failed to wait for file changes: {}", strerror(errno));
+            throw std::runtime_error("Failed to wait for file changes");
+        }
+        if (result == 0)
+            return changes; // settled
+
+        read_events(changes, seen);
+    }
+}
+
+#endif
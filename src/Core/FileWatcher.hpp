@@ -0,0 +1,44 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// Wait for changes of files (inotify)
+/// The directories of watched files are watched - editors often save by replacing the file instead of writing it
+class FileWatcher {
+public:
+    struct Changes {
+        std::vector<std::filesystem::path> modified;          // watched files that were written, replaced or removed
+        std::vector<std::filesystem::path> directory_entries; // other files created, removed or renamed in watched directories
+    };
+
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&)            = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /// Watch file
+    void add(const std::filesystem::path& path);
+
+    /// Block until something changed, then collect changes until nothing changed for settle_time
+    Changes wait(std::chrono::milliseconds settle_time);
+
+    size_t get_file_count() const { return m_files.size(); }
+    size_t get_directory_count() const { return m_directories.size(); }
+
+private:
+    /// Read pending events into changes (seen - paths already in changes)
+    void read_events(Changes& changes, std::unordered_set<std::string>& seen);
+
+private:
+    int m_fd = -1;
+    std::unordered_set<std::string> m_files;
+    std::unordered_map<std::string, int> m_directories;  // directory -> watch descriptor
+    std::unordered_map<int, std::string> m_descriptors; // watch descriptor -> directory
+    bool m_limit_reached = false;
+};
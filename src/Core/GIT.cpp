@@ -1,50 +1,513 @@
 #include "GIT.hpp"
 #include <CommandUtils.hpp>
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 GIT::GIT(const std::filesystem::path& working_directory) : m_working_directory(working_directory) {}
 
+// read first line of file without trailing whitespace
+static std::string read_first_line(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    line.erase(line.find_last_not_of(" \t\n\r\f\v") + 1);
+    return line;
+}
+
+// .git directory or "gitdir: <path>" file (worktrees/submodules) of repository root
+static std::filesystem::path find_git_directory(const std::filesystem::path& root) {
+    const auto dot_git = root / ".git";
+    if (std::filesystem::is_directory(dot_git))
+        return dot_git;
+
+    if (std::filesystem::is_regular_file(dot_git)) {
+        const auto line = read_first_line(dot_git);
+        if (line.starts_with("gitdir: ")) {
+            const std::filesystem::path git_dir = line.substr(8);
+            return git_dir.is_relative() ? root / git_dir : git_dir;
+        }
+    }
+
+    return {};
+}
+
+// linked worktrees keep shared refs, objects and config in the common directory
+static std::filesystem::path get_common_directory(const std::filesystem::path& git_dir) {
+    const auto common_file = git_dir / "commondir";
+    if (!std::filesystem::exists(common_file))
+        return git_dir;
+
+    const std::filesystem::path dir = read_first_line(common_file);
+    return dir.is_relative() ? git_dir / dir : dir;
+}
+
+// resolve ref (refs/heads/...) from loose ref file or packed-refs
+static std::string resolve_ref(const std::filesystem::path& git_dir, const std::string& ref) {
+    const auto common_dir = get_common_directory(git_dir);
+
+    for (const auto& dir : {git_dir, common_dir}) {
+        if (std::filesystem::is_regular_file(dir / ref))
+            return read_first_line(dir / ref);
+    }
+
+    std::ifstream packed_refs(common_dir / "packed-refs");
+    std::string line;
+    while (std::getline(packed_refs, line)) {
+        // "<hash> <ref>", comments start with '#', peeled tags with '^'
+        if (line.empty() || line[0] == '#' || line[0] == '^')
+            continue;
+        line.erase(line.find_last_not_of(" \t\n\r\f\v") + 1);
+        const auto space = line.find(' ');
+        if (space != std::string::npos && line.compare(space + 1, std::string::npos, ref) == 0)
+            return line.substr(0, space);
+    }
+
+    return "";
+}
+
+// Repository metadata read directly from the .git directory
+struct RepositoryInfo {
+    std::filesystem::path root; // empty if not in a git repository
+    std::filesystem::path git_dir;
+    std::string branch;         // "HEAD" if detached
+    std::string commit;         // full hash, empty if HEAD can not be resolved
+};
+
+// per working directory - cleared for a repository when git changes its HEAD
+static std::unordered_map<std::string, RepositoryInfo> s_repository_cache;
+static std::mutex s_mutex_repository_cache;
+
+static RepositoryInfo read_repository_info(const std::filesystem::path& working_directory) {
+    RepositoryInfo info;
+
+    // search for repository root upwards like git does
+    std::error_code ec;
+    auto dir = std::filesystem::weakly_canonical(std::filesystem::absolute(working_directory), ec);
+    std::filesystem::path git_dir;
+    while (!ec) {
+        git_dir = find_git_directory(dir);
+        if (!git_dir.empty()) {
+            info.root    = dir;
+            info.git_dir = git_dir;
+            break;
+        }
+        if (dir == dir.parent_path())
+            return info;
+        dir = dir.parent_path();
+    }
+    if (ec)
+        return info;
+
+    const auto head = read_first_line(git_dir / "HEAD");
+    if (head.starts_with("ref: ")) {
+        const auto ref = head.substr(5);
+        info.branch    = ref.starts_with("refs/heads/") ? ref.substr(11) : ref;
+        info.commit    = resolve_ref(git_dir, ref);
+    } else {
+        info.branch = "HEAD";
+        info.commit = head;
+    }
+
+    return info;
+}
+
+static RepositoryInfo get_repository_info(const std::filesystem::path& working_directory) {
+    const auto key = working_directory.string();
+    {
+        std::lock_guard<std::mutex> lock(s_mutex_repository_cache);
+        const auto it = s_repository_cache.find(key);
+        if (it != s_repository_cache.end())
+            return it->second;
+    }
+
+    auto info = read_repository_info(working_directory);
+
+    std::lock_guard<std::mutex> lock(s_mutex_repository_cache);
+    s_repository_cache[key] = info;
+    return info;
+}
+
+// HEAD of repository containing working_directory changed
+static void invalidate_repository_info(const std::filesystem::path& working_directory) {
+    const auto root = get_repository_info(working_directory).root;
+
+    std::lock_guard<std::mutex> lock(s_mutex_repository_cache);
+    s_repository_cache.erase(working_directory.string());
+    if (root.empty())
+        return;
+    std::erase_if(s_repository_cache, [&](const auto& entry) {
+        return entry.second.root == root;
+    });
+}
+
 // static function
-bool GIT::clone_branch(const std::filesystem::path& target, const std::string& url, const std::string& branch) {
-    // clone url to target at specific branch, do a shallow clone
-    const auto [exit_code, output] =
-        execute_with_args("git",
-                          branch.empty() ? std::vector<std::string>{"clone", "--depth", "1", "--branch", branch, url, target.string()} :
-                                           std::vector<std::string>{"clone", "--depth", "1", url, target.string()});
+void GIT::invalidate_cache() {
+    std::lock_guard<std::mutex> lock(s_mutex_repository_cache);
+    s_repository_cache.clear();
+}
 
-    if (exit_code) {
-        Log.error("git clone failed: {}", output);
+// Commit abbreviation like "git rev-parse --short" - core.abbrev or a length based on the object count,
+// extended until no other object starts with the same characters
+// Only SHA-1 repositories with version 2 pack indexes and config files without includes are read, everything else is left to git
+
+static constexpr size_t OBJECT_NAME_SIZE       = 20;
+static constexpr size_t DEFAULT_ABBREV_LENGTH  = 7;
+static constexpr size_t MINIMUM_ABBREV_LENGTH  = 4;
+static constexpr char PACK_INDEX_MAGIC[4]      = {'\377', 't', 'O', 'c'};
+static constexpr uint32_t PACK_INDEX_VERSION   = 2;
+static constexpr size_t PACK_INDEX_FANOUT_SIZE = 256 * sizeof(uint32_t);
+
+static std::string trim(const std::string& str) {
+    const auto first = str.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos)
+        return "";
+    return str.substr(first, str.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+static std::string to_lower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) {
+        return std::tolower(c);
+    });
+    return str;
+}
+
+// read core.abbrev from git config file - value is not changed if the file does not set it
+// Returns false if the file uses syntax that is not parsed here (include directives, continued lines, keys after a section header)
+static bool read_core_abbrev(const std::filesystem::path& path, std::string& value) {
+    std::ifstream config(path);
+    std::string line;
+    bool in_core = false;
+    while (std::getline(config, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';')
+            continue;
+        if (line.back() == '\\')
+            return false;
+
+        if (line[0] == '[') {
+            const auto end = line.find(']');
+            if (end == std::string::npos)
+                return false;
+            const auto rest = trim(line.substr(end + 1));
+            if (!rest.empty() && rest[0] != '#' && rest[0] != ';')
+                return false;
+
+            const auto section = to_lower(trim(line.substr(1, end - 1)));
+            if (section == "include" || section.starts_with("includeif"))
+                return false;
+            in_core = section == "core";
+            continue;
+        }
+
+        if (!in_core)
+            continue;
+
+        // "abbrev" without value is boolean true - not a valid abbreviation, left to git
+        const auto separator = line.find('=');
+        const auto key       = to_lower(trim(line.substr(0, separator)));
+        if (key != "abbrev")
+            continue;
+        if (separator == std::string::npos) {
+            value = "true";
+            continue;
+        }
+
+        auto entry_value = line.substr(separator + 1);
+        entry_value      = trim(entry_value.substr(0, entry_value.find_first_of("#;")));
+        if (entry_value.size() >= 2 && entry_value.front() == '"' && entry_value.back() == '"')
+            entry_value = entry_value.substr(1, entry_value.size() - 2);
+        value = to_lower(entry_value);
+    }
+    return true;
+}
+
+// core.abbrev from all config files git reads, in git's order (later files override earlier ones)
+// Returns false if a config source is not supported here - the abbreviation is then left to git
+static bool read_core_abbrev(const std::filesystem::path& git_dir, const std::filesystem::path& common_dir, std::string& value) {
+    // config files or values given through the environment
+    for (const auto name : {"GIT_CONFIG_GLOBAL", "GIT_CONFIG_SYSTEM", "GIT_CONFIG", "GIT_CONFIG_COUNT", "GIT_CONFIG_PARAMETERS"}) {
+        if (getenv(name))
+            return false;
+    }
+
+#ifdef WINDOWS_BUILD
+    // system config location depends on the git installation
+    return false;
+#else
+    if (!getenv("GIT_CONFIG_NOSYSTEM")) {
+        // distribution packages use /etc, source builds /usr/local/etc
+        if (std::filesystem::exists("/usr/local/etc/gitconfig"))
+            return false;
+        if (!read_core_abbrev("/etc/gitconfig", value))
+            return false;
+    }
+
+    const char* home       = getenv("HOME");
+    const char* xdg_config = getenv("XDG_CONFIG_HOME");
+    if (xdg_config && *xdg_config) {
+        if (!read_core_abbrev(std::filesystem::path(xdg_config) / "git" / "config", value))
+            return false;
+    } else if (home && *home) {
+        if (!read_core_abbrev(std::filesystem::path(home) / ".config" / "git" / "config", value))
+            return false;
+    }
+    if (home && *home && !read_core_abbrev(std::filesystem::path(home) / ".gitconfig", value))
+        return false;
+
+    // config.worktree is only read with extensions.worktreeConfig - its presence is enough to not guess
+    if (std::filesystem::exists(git_dir / "config.worktree") || std::filesystem::exists(common_dir / "config.worktree"))
         return false;
+    return read_core_abbrev(common_dir / "config", value);
+#endif
+}
+
+static std::string hex_object_name(const char* name) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    std::string result(OBJECT_NAME_SIZE * 2, '0');
+    for (size_t i = 0; i < OBJECT_NAME_SIZE; i++) {
+        result[i * 2]     = HEX[(uint8_t)name[i] >> 4];
+        result[i * 2 + 1] = HEX[(uint8_t)name[i] & 0xF];
     }
+    return result;
+}
 
-    return true;
+static size_t common_prefix_length(std::string_view a, std::string_view b) {
+    size_t length = 0;
+    while (length < a.size() && length < b.size() && a[length] == b[length])
+        length++;
+    return length;
 }
 
-bool GIT::is_git_repository() const {
-    // run git command to check if working directory is a git repo
-    const auto [exit_code, output] = execute_with_args("git", {"-C", get_working_directory().string(), "rev-parse"});
+static uint32_t read_big_endian(const char* data) {
+    return ((uint32_t)(uint8_t)data[0] << 24) | ((uint32_t)(uint8_t)data[1] << 16) | ((uint32_t)(uint8_t)data[2] << 8) | (uint8_t)data[3];
+}
 
-    if (exit_code)
+// object directory and its alternates
+static std::vector<std::filesystem::path> get_object_directories(const std::filesystem::path& common_dir) {
+    std::vector<std::filesystem::path> directories = {common_dir / "objects"};
+    std::ifstream alternates(common_dir / "objects" / "info" / "alternates");
+    std::string line;
+    while (std::getline(alternates, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+        const std::filesystem::path dir = line;
+        directories.push_back(dir.is_relative() ? common_dir / "objects" / dir : dir);
+    }
+    return directories;
+}
+
+/// Pack index (objects/pack/*.idx): magic, version, fanout table (object count per first byte), sorted object names
+class PackIndex {
+public:
+    PackIndex(const std::filesystem::path& path) : m_file(path, std::ios::binary) {
+        char header[sizeof(PACK_INDEX_MAGIC) + sizeof(uint32_t)];
+        char fanout[PACK_INDEX_FANOUT_SIZE];
+        m_file.read(header, sizeof(header));
+        m_file.read(fanout, sizeof(fanout));
+        if (!m_file || std::memcmp(header, PACK_INDEX_MAGIC, sizeof(PACK_INDEX_MAGIC)) != 0 ||
+            read_big_endian(header + sizeof(PACK_INDEX_MAGIC)) != PACK_INDEX_VERSION)
+            return;
+
+        for (size_t i = 0; i < 256; i++) {
+            m_fanout[i] = read_big_endian(fanout + i * sizeof(uint32_t));
+        }
+        m_valid = true;
+    }
+
+    bool is_valid() const { return m_valid; }
+    uint32_t get_object_count() const { return m_fanout[255]; }
+
+    /// Longest number of hex characters another object in the pack shares with commit
+    /// Returns false if the index can not be read
+    bool get_longest_common_prefix(const std::string& commit, const char* commit_name, size_t& length) {
+        const auto first_byte = (uint8_t)commit_name[0];
+        uint32_t low          = first_byte ? m_fanout[first_byte - 1] : 0;
+        uint32_t high         = m_fanout[first_byte];
+
+        // first object name not less than commit - other objects with the longest common prefix are next to it
+        char name[OBJECT_NAME_SIZE];
+        while (low < high) {
+            const auto middle = low + (high - low) / 2;
+            if (!read_name(middle, name))
+                return false;
+            if (std::memcmp(name, commit_name, OBJECT_NAME_SIZE) < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        for (const auto index : {(int64_t)low - 1, (int64_t)low, (int64_t)low + 1}) {
+            if (index < 0 || index >= get_object_count())
+                continue;
+            if (!read_name(index, name))
+                return false;
+            if (std::memcmp(name, commit_name, OBJECT_NAME_SIZE) != 0)
+                length = std::max(length, common_prefix_length(hex_object_name(name), commit));
+        }
+        return true;
+    }
+
+private:
+    bool read_name(uint32_t index, char* name) {
+        m_file.seekg(sizeof(PACK_INDEX_MAGIC) + sizeof(uint32_t) + PACK_INDEX_FANOUT_SIZE + (uint64_t)index * OBJECT_NAME_SIZE);
+        m_file.read(name, OBJECT_NAME_SIZE);
+        return (bool)m_file;
+    }
+
+private:
+    std::ifstream m_file;
+    uint32_t m_fanout[256] = {};
+    bool m_valid           = false;
+};
+
+// Returns empty string if the repository can not be read (SHA-256, unsupported pack index or config, unknown core.abbrev)
+static std::string abbreviate_commit(const RepositoryInfo& info) {
+    if (info.commit.size() != OBJECT_NAME_SIZE * 2)
+        return "";
+
+    char commit_name[OBJECT_NAME_SIZE];
+    for (size_t i = 0; i < OBJECT_NAME_SIZE; i++) {
+        const auto byte = info.commit.substr(i * 2, 2);
+        if (byte.find_first_not_of("0123456789abcdef") != std::string::npos)
+            return "";
+        commit_name[i] = (char)std::stoul(byte, nullptr, 16);
+    }
+
+    const auto common_dir = get_common_directory(info.git_dir);
+
+    std::string abbrev;
+    if (!read_core_abbrev(info.git_dir, common_dir, abbrev))
+        return "";
+
+    if (abbrev == "no" || abbrev == "false")
+        return info.commit;
+
+    std::vector<std::unique_ptr<PackIndex>> pack_indexes;
+    std::error_code ec;
+    for (const auto& objects_dir : get_object_directories(common_dir)) {
+        for (const auto& entry : std::filesystem::directory_iterator(objects_dir / "pack", ec)) {
+            if (entry.path().extension() != ".idx")
+                continue;
+            auto pack_index = std::make_unique<PackIndex>(entry.path());
+            if (!pack_index->is_valid())
+                return "";
+            pack_indexes.push_back(std::move(pack_index));
+        }
+    }
+
+    size_t length = 0;
+    if (abbrev.empty() || abbrev == "auto") {
+        // git expects a collision at 2^(bits/2) objects - 4 bits per hex character
+        uint64_t object_count = 0;
+        for (const auto& pack_index : pack_indexes) {
+            object_count += pack_index->get_object_count();
+        }
+        length = (std::bit_width(object_count) + 1) / 2;
+        length = std::max(length, DEFAULT_ABBREV_LENGTH);
+    } else {
+        if (abbrev.find_first_not_of("0123456789") != std::string::npos || abbrev.size() > 2)
+            return "";
+        length = std::clamp<size_t>(std::stoul(abbrev), MINIMUM_ABBREV_LENGTH, OBJECT_NAME_SIZE * 2);
+    }
+
+    // longest prefix shared with another packed or loose object
+    size_t shared_length = 0;
+    for (const auto& pack_index : pack_indexes) {
+        if (!pack_index->get_longest_common_prefix(info.commit, commit_name, shared_length))
+            return "";
+    }
+    for (const auto& objects_dir : get_object_directories(common_dir)) {
+        const auto loose_prefix = info.commit.substr(0, 2);
+        for (const auto& entry : std::filesystem::directory_iterator(objects_dir / loose_prefix, ec)) {
+            const auto name = loose_prefix + entry.path().filename().string();
+            if (name != info.commit)
+                shared_length = std::max(shared_length, common_prefix_length(name, info.commit));
+        }
+    }
+
+    return info.commit.substr(0, std::max(length, shared_length + 1));
+}
+
+// static function
+bool GIT::clone_branch(const std::filesystem::path& target,
+                       const std::string& url,
+                       const std::string& branch,
+                       const std::filesystem::path& reference) {
+    std::vector<std::string> args = {"clone"};
+    if (reference.empty()) {
+        // shallow clone
+        args.insert(args.end(), {"--depth", "1"});
+    } else {
+        // objects are read from reference - nothing to download
+        args.insert(args.end(), {"--reference", reference.string()});
+    }
+    if (!branch.empty())
+        args.insert(args.end(), {"--branch", branch});
+    args.insert(args.end(), {url, target.string()});
+
+    const auto [exit_code, output] = execute_with_args("git", args);
+    invalidate_repository_info(target);
+
+    if (exit_code) {
+        Log.error("git clone failed: {}", output);
         return false;
+    }
 
-    return output.find("fatal: not a git repository") == std::string::npos;
+    return true;
 }
 
-bool GIT::is_git_root() const {
-    // if toplevel path is same as working directory, then working directory is the root folder
-    auto [exit_code, output] = execute_with_args("git", {"-C", get_working_directory().string(), "rev-parse", "--show-toplevel"});
+// static function
+bool GIT::clone_mirror(const std::filesystem::path& target, const std::string& url) {
+    const auto [exit_code, output] = execute_with_args("git", {"clone", "--bare", url, target.string()});
     if (exit_code) {
-        throw std::runtime_error("git command error");
+        Log.error("git clone failed: {}", output);
+        return false;
     }
 
-    if (output.find("fatal: not a git repository") != std::string::npos) {
+    // bare clones have no fetch refspec - fetch() has to update all branches
+    const auto [config_exit_code, config_output] =
+        execute_with_args("git", {"-C", target.string(), "config", "remote.origin.fetch", "+refs/heads/*:refs/heads/*"});
+    if (config_exit_code) {
+        Log.error("git config failed: {}", config_output);
         return false;
     }
 
-    if (output.size())
-        output.pop_back(); // remove last newline
+    return true;
+}
 
-    return std::filesystem::equivalent(output, std::filesystem::absolute(get_working_directory()));
+bool GIT::is_git_repository() const {
+    return !get_repository_info(get_working_directory()).root.empty(); //
+}
+
+bool GIT::is_git_root() const {
+    const auto root = get_repository_info(get_working_directory()).root;
+    if (root.empty())
+        return false;
+
+    std::error_code ec;
+    return std::filesystem::equivalent(root, get_working_directory(), ec);
+}
+
+bool GIT::have_missing_alternates() const {
+    std::ifstream alternates(get_working_directory() / ".git" / "objects" / "info" / "alternates");
+    std::string line;
+    while (std::getline(alternates, line)) {
+        line.erase(line.find_last_not_of(" \t\n\r\f\v") + 1);
+        if (!line.empty() && line[0] != '#' && !std::filesystem::exists(line))
+            return true;
+    }
+    return false;
 }
 
 bool GIT::have_changes() const {
@@ -71,6 +534,7 @@ void GIT::fetch() const {
 void GIT::pull() const {
     // pull current branch
     const auto [exit_code, output] = execute_with_args("git", {"-C", get_working_directory().string(), "pull"});
+    invalidate_repository_info(get_working_directory());
     if (exit_code) {
         Log.error("Git pull failed:\n{}", output);
         throw std::runtime_error("git command error");
@@ -83,6 +547,7 @@ bool GIT::checkout(const std::string& branch) const {
 
     // checkout specific branch and pull
     const auto [exit_code, output] = execute_with_args("git", {"-C", get_working_directory().string(), "checkout", branch});
+    invalidate_repository_info(get_working_directory());
     if (exit_code) {
         Log.error("Git checkout failed:\n{}", output);
         throw std::runtime_error("git command error");
@@ -91,32 +556,56 @@ bool GIT::checkout(const std::string& branch) const {
     return true;
 }
 
-std::string GIT::get_current_branch() const {
-    // get current branch name
-    auto [exit_code, output] = execute_with_args("git", {"-C", get_working_directory().string(), "rev-parse", "--abbrev-ref", "HEAD"});
+void GIT::checkout_commit(const std::string& commit) const {
+    const auto working_directory = get_working_directory().string();
+
+    // shallow clones only have the branch head
+    const auto [have_commit, have_output] = execute_with_args("git", {"-C", working_directory, "cat-file", "-e", commit + "^{commit}"});
+    if (have_commit != 0) {
+        const auto [exit_code, output] = execute_with_args("git", {"-C", working_directory, "fetch", "origin", commit});
+        if (exit_code) {
+            Log.error("Git fetch failed:\n{}", output);
+            throw std::runtime_error("git command error");
+        }
+    }
+
+    const auto [exit_code, output] = execute_with_args("git", {"-C", working_directory, "checkout", "--detach", commit});
+    invalidate_repository_info(get_working_directory());
     if (exit_code) {
-        Log.error("Git rev-parse failed:\n{}", output);
+        Log.error("Git checkout failed:\n{}", output);
         throw std::runtime_error("git command error");
     }
+}
 
-    // trim output start and end from spaces and whitespace
-    output.erase(0, output.find_first_not_of(" \t\n\r\f\v"));
-    output.erase(output.find_last_not_of(" \t\n\r\f\v") + 1);
+std::string GIT::get_current_branch() const {
+    const auto info = get_repository_info(get_working_directory());
+    if (info.root.empty()) {
+        Log.error("Failed to get git branch: \"{}\" is not a git repository", get_working_directory());
+        throw std::runtime_error("git command error");
+    }
 
-    return output;
+    return info.branch;
 }
 
 std::string GIT::get_current_short_hash() const {
-    // get current commit hash
-    auto [exit_code, output] = execute_with_args("git", {"-C", get_working_directory().string(), "rev-parse", "--short", "HEAD"});
-    if (exit_code) {
-        Log.error("Git rev-parse failed:\n{}", output);
+    const auto info = get_repository_info(get_working_directory());
+    if (info.commit.empty()) {
+        Log.error("Failed to get git commit hash of \"{}\"", get_working_directory());
         throw std::runtime_error("git command error");
     }
 
-    // trim output start and end from spaces and whitespace
-    output.erase(0, output.find_first_not_of(" \t\n\r\f\v"));
-    output.erase(output.find_last_not_of(" \t\n\r\f\v") + 1);
+    const auto short_hash = abbreviate_commit(info);
+    if (!short_hash.empty())
+        return short_hash;
+
+    const auto [exit_code, output] = execute_with_args("git", {"-C", get_working_directory().string(), "rev-parse", "--short", "HEAD"});
+    if (exit_code) {
+        Log.error("Failed to get git commit hash of \"{}\":\n{}", get_working_directory(), output);
+        throw std::runtime_error("git command error");
+    }
+    return trim(output);
+}
 
-    return output;
+std::string GIT::get_head_commit() const {
+    return get_repository_info(get_working_directory()).commit; //
 }
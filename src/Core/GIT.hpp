@@ -1,12 +1,25 @@
 #pragma once
 
 #include <filesystem>
+
+// Repository state (root, branch, commit) is read from the .git directory without running git and cached per run
+// Only operations that change or fully inspect the working tree run git
 class GIT {
 public:
     GIT(const std::filesystem::path& working_directory);
 
     // Clone specific branch to location
-    static bool clone_branch(const std::filesystem::path& target, const std::string& url, const std::string& branch);
+    // reference - local mirror to borrow objects from (full clone), otherwise shallow clone
+    static bool clone_branch(const std::filesystem::path& target,
+                             const std::string& url,
+                             const std::string& branch,
+                             const std::filesystem::path& reference = {});
+
+    // Bare clone of all branches and tags - updated with fetch()
+    static bool clone_mirror(const std::filesystem::path& target, const std::string& url);
+
+    // Forget cached repository state of all working directories (repositories may have changed outside of this process)
+    static void invalidate_cache();
 
     // Check if working directory is a git repository
     bool is_git_repository() const;
@@ -14,6 +27,9 @@ public:
     // Check if working directory is a git repository root
     bool is_git_root() const;
 
+    // Check if repository borrows objects from a repository that does not exist anymore
+    bool have_missing_alternates() const;
+
     // Check if repository has uncommitted changes
     bool have_changes() const;
 
@@ -26,9 +42,16 @@ public:
     // Set branch @ commit
     bool checkout(const std::string& branch) const;
 
+    // Detach HEAD at commit - fetched from origin if it is not available locally
+    void checkout_commit(const std::string& commit) const;
+
     std::string get_current_branch() const;
     std::string get_current_short_hash() const;
 
+    // Full commit hash of HEAD
+    // Returns empty string if working directory is not in a git repository or HEAD can not be resolved
+    std::string get_head_commit() const;
+
     const std::filesystem::path& get_working_directory() const { return m_working_directory; }
 
 private:
@@ -0,0 +1,234 @@
+#include "GitImportResolver.hpp"
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include "Core/GIT.hpp"
+#include "Core/GlobalConfig.hpp"
+
+// number of repositories cloned/updated at the same time
+static constexpr ptrdiff_t MAX_CONCURRENT_GIT_IMPORTS = 8;
+
+GitImportResolver::GitImportResolver(const std::filesystem::path& external_directory,
+                                     ImportLock& import_lock,
+                                     GitMirrorCache* mirror_cache) :
+    m_external_directory(external_directory),
+    m_import_lock(import_lock),
+    m_mirror_cache(mirror_cache),
+    m_semaphore(MAX_CONCURRENT_GIT_IMPORTS) {}
+
+GitImportResolver::~GitImportResolver() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [path, request] : m_requests) {
+        request.result.wait();
+    }
+}
+
+bool GitImportResolver::get_target(std::string& url, std::filesystem::path& path) const {
+    // trim spaces from start and end
+    const auto first = url.find_first_not_of(" \t");
+    if (first == std::string::npos)
+        return false;
+    url = url.substr(first);
+    url = url.substr(0, url.find_last_not_of(" \t") + 1);
+
+    if (url.length() < 4 || url.substr(url.length() - 4) != ".git") {
+        url += ".git";
+    }
+
+    static const std::regex git_url_regex(R"(http[s]?:\/\/.+\/([\w-]+)\/([\w-]+)\.git)");
+    std::smatch match;
+    if (!std::regex_search(url, match, git_url_regex))
+        return false;
+
+    const auto owner = match[1].str();
+    const auto name  = match[2].str();
+    path             = m_external_directory / (owner + "_" + name);
+    return true;
+}
+
+void GitImportResolver::prefetch(const std::filesystem::path& script_path) {
+    std::ifstream script_file(script_path);
+    if (!script_file.is_open())
+        return;
+
+    // import_git("url") / import_git("url", "branch") with literal arguments
+    static const std::regex import_git_regex(R"re(import_git\s*\(\s*(["'])([^"']+)\1\s*(?:,\s*(["'])([^"']*)\3)?)re");
+
+    std::string line;
+    while (std::getline(script_file, line)) {
+        // skip commented out lines
+        const auto first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line.compare(first, 2, "--") == 0)
+            continue;
+
+        for (auto it = std::sregex_iterator(line.begin(), line.end(), import_git_regex); it != std::sregex_iterator(); ++it) {
+            auto url          = (*it)[2].str();
+            const auto branch = (*it)[4].str();
+
+            std::filesystem::path path;
+            if (get_target(url, path)) {
+                Log.trace("Prefetch git import \"{}\"", url);
+                start(url, branch, path);
+            }
+        }
+    }
+}
+
+GitImportResolver::Result GitImportResolver::resolve(const std::string& url, const std::string& branch) {
+    std::filesystem::path path;
+    auto normalized_url = url;
+    if (!get_target(normalized_url, path))
+        return {false, "Unsupported git url: \"" + url + "\""};
+
+    std::shared_future<Result> previous;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_requests.find(path.string());
+        if (it != m_requests.end()) {
+            if (it->second.branch == branch)
+                return it->second.result.get();
+
+            // same repository imported with another branch - update again after previous update is done
+            previous = it->second.result;
+            m_requests.erase(it);
+        }
+    }
+
+    if (previous.valid())
+        previous.wait();
+
+    return start(normalized_url, branch, path).get();
+}
+
+std::shared_future<GitImportResolver::Result> GitImportResolver::start(const std::string& url,
+                                                                       const std::string& branch,
+                                                                       const std::filesystem::path& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_requests.find(path.string());
+    if (it != m_requests.end())
+        return it->second.result;
+
+    auto result = std::async(std::launch::async, [this, url, branch, path]() {
+                      m_semaphore.acquire();
+                      Result result;
+                      try {
+                          result = GlobalConfig::offline_imports() ? check_offline(url, path) : update_or_clone(url, branch, path);
+                      } catch (const std::exception& e) {
+                          result = {false, fmt::format("Failed to update repository \"{}\" at \"{}\"\n{}", url, path, e.what())};
+                      }
+                      m_semaphore.release();
+                      return result;
+                  }).share();
+
+    m_requests[path.string()] = {branch, result};
+    return result;
+}
+
+GitImportResolver::Result GitImportResolver::update_or_clone(const std::string& url,
+                                                             const std::string& branch,
+                                                             const std::filesystem::path& path) {
+    // imports in the lock file stay at their locked commit until an update is requested
+    const auto locked_commit = GlobalConfig::update_imports() ? std::string{} : m_import_lock.get_commit(url);
+
+    // objects of checkout are in a mirror that has been removed - never delete the checkout, it may have changes
+    const bool uses_mirror = std::filesystem::exists(path / ".git" / "objects" / "info" / "alternates");
+    if (uses_mirror && GIT(path).have_missing_alternates()) {
+        return {false,
+                fmt::format("Repository \"{}\" at \"{}\" uses objects of a git mirror that has been removed\nPotential fix: Save "
+                            "uncommitted changes, delete the directory and reconfigure",
+                            url,
+                            path)};
+    }
+
+    // mirrors are not evicted while checkouts use them
+    if (uses_mirror && m_mirror_cache)
+        m_mirror_cache->add_checkout(url, path);
+
+    if (!std::filesystem::exists(path)) {
+        const auto mirror = m_mirror_cache ? m_mirror_cache->get_mirror(url) : std::filesystem::path{};
+        Log.info("Clone \"{}\" to \"{}\"", url, path.filename());
+        if (!GIT::clone_branch(path, url, branch, mirror))
+            return {false, fmt::format("Failed to clone repository \"{}\" to \"{}\"", url, path)};
+        if (!mirror.empty())
+            m_mirror_cache->add_checkout(url, path);
+        if (!locked_commit.empty() && GIT(path).get_head_commit() != locked_commit) {
+            Log.trace("Check out locked commit {} [{}]", locked_commit, path);
+            GIT(path).checkout_commit(locked_commit);
+        }
+        m_import_lock.set_commit(url, GIT(path).get_head_commit());
+        return {true, ""};
+    }
+
+    GIT git(path);
+    if (!git.is_git_repository()) {
+        return {false,
+                fmt::format("Failed to update repository \"{}\" at \"{}\"\nDirectory is not a git repository\nPotential fix: Delete the "
+                            "directory and reconfigure",
+                            url,
+                            path)};
+    }
+
+    if (!git.is_git_root()) {
+        return {false,
+                fmt::format("Failed to update repository \"{}\" at \"{}\"\nDirectory is not a git repository root directory\nPotential "
+                            "fix: Delete the directory and reconfigure",
+                            url,
+                            path)};
+    }
+
+    if (GlobalConfig::skip_git_import_update()) {
+        Log.trace("Skip repository update [{}]\n    ({})", path, url);
+    } else if (!locked_commit.empty()) {
+        if (git.get_head_commit() != locked_commit) {
+            if (git.have_changes()) {
+                Log.warn("Not checking out locked commit of git repository \"{}\" - uncommitted changes\n    ({})", path, url);
+            } else {
+                Log.trace("Check out locked commit {} [{}]\n    ({})", locked_commit, path, url);
+                // new objects are fetched into the shared mirror once - the checkout reads them from there
+                if (uses_mirror && m_mirror_cache)
+                    m_mirror_cache->get_mirror(url);
+                git.checkout_commit(locked_commit);
+            }
+        }
+    } else {
+        if (git.have_changes()) {
+            Log.warn("Not updating git repository \"{}\" - uncommitted changes\n    ({})", path, url);
+        } else {
+            Log.trace("Pull repository updates [{}]\n    ({})", path, url);
+            // new objects are fetched into the shared mirror once - pull only has to update refs
+            if (uses_mirror && m_mirror_cache)
+                m_mirror_cache->get_mirror(url);
+            if (git.checkout(branch))
+                git.pull();
+        }
+    }
+
+    m_import_lock.set_commit(url, git.get_head_commit());
+    return {true, ""};
+}
+
+GitImportResolver::Result GitImportResolver::check_offline(const std::string& url, const std::filesystem::path& path) {
+    const auto commit = GIT(path).get_head_commit();
+    if (commit.empty())
+        return {false, fmt::format("Repository \"{}\" is not available at \"{}\" (offline)", url, path)};
+
+    m_import_lock.set_commit(url, commit);
+
+    const auto locked_commit = m_import_lock.get_commit(url);
+    if (locked_commit == commit)
+        return {true, ""};
+
+    const auto message = locked_commit.empty() ?
+                             fmt::format("Repository \"{}\" is not in {}", url, m_import_lock.get_path()) :
+                             fmt::format("Repository \"{}\" at \"{}\" is at {} but {} requires {}",
+                                         url,
+                                         path,
+                                         commit,
+                                         m_import_lock.get_path().filename(),
+                                         locked_commit);
+    if (GlobalConfig::frozen_imports())
+        return {false, message};
+
+    Log.warn("{}", message);
+    return {true, ""};
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <semaphore>
+#include <string>
+#include <unordered_map>
+#include "GitMirrorCache.hpp"
+#include "ImportLock.hpp"
+
+/// Clones/updates import_git repositories in background
+/// Scripts are scanned for literal import_git("url", "branch") calls before they are executed,
+/// so all git imports of a script are fetched at the same time instead of one after another
+/// Imports in the import lock are checked out at their locked commit, others (and all with --update-imports) at their branch head
+/// Resolved commits are recorded in the import lock, offline/frozen mode only checks checkouts against it
+class GitImportResolver {
+public:
+    struct Result {
+        bool success;
+        std::string error; // error message if not successful
+    };
+
+public:
+    /// Imports are checked out to external_directory/<owner>_<name>
+    /// mirror_cache - optional shared object store for checkouts
+    GitImportResolver(const std::filesystem::path& external_directory, ImportLock& import_lock, GitMirrorCache* mirror_cache);
+    /// Waits for all background updates
+    ~GitImportResolver();
+
+    /// Normalize url (trim, append .git) and get checkout path
+    /// Returns false if url is not supported
+    bool get_target(std::string& url, std::filesystem::path& path) const;
+
+    /// Start resolving all literal import_git calls of a script in background
+    void prefetch(const std::filesystem::path& script_path);
+
+    /// Clone or update repository - waits for background update of the same repository
+    Result resolve(const std::string& url, const std::string& branch);
+
+private:
+    std::shared_future<Result> start(const std::string& url, const std::string& branch, const std::filesystem::path& path);
+    Result update_or_clone(const std::string& url, const std::string& branch, const std::filesystem::path& path);
+    Result check_offline(const std::string& url, const std::filesystem::path& path);
+
+private:
+    struct Request {
+        std::string branch;
+        std::shared_future<Result> result;
+    };
+
+    std::filesystem::path m_external_directory;
+    ImportLock& m_import_lock;
+    GitMirrorCache* m_mirror_cache;
+    std::counting_semaphore<> m_semaphore; // limits number of concurrent git operations
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Request> m_requests; // key: checkout path
+};
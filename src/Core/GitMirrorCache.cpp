@@ -0,0 +1,198 @@
+#include "GitMirrorCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include "Core/GIT.hpp"
+#include "HashUtils.hpp"
+
+// written on every use - mtime is used for LRU eviction
+static constexpr const char* LAST_USED_FILE = "cfxs-last-used";
+// checkouts that borrow objects from the mirror - one path per line
+static constexpr const char* CHECKOUTS_FILE = "cfxs-checkouts";
+
+static std::vector<std::string> read_lines(const std::filesystem::path& path) {
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty())
+            lines.push_back(line);
+    }
+    return lines;
+}
+
+// alternates of checkout include the objects directory of mirror
+static bool uses_mirror(const std::filesystem::path& checkout_path, const std::filesystem::path& mirror_path) {
+    std::error_code ec;
+    const auto mirror_objects = std::filesystem::weakly_canonical(mirror_path / "objects", ec);
+    for (const auto& line : read_lines(checkout_path / ".git" / "objects" / "info" / "alternates")) {
+        const std::filesystem::path alternate = line;
+        if (std::filesystem::weakly_canonical(checkout_path / ".git" / "objects" / alternate, ec) == mirror_objects)
+            return true;
+    }
+    return false;
+}
+
+GitMirrorCache::GitMirrorCache(const std::filesystem::path& directory, uint64_t max_size_bytes) :
+    m_directory(directory), m_max_size_bytes(max_size_bytes) {}
+
+std::filesystem::path GitMirrorCache::get_default_directory() {
+    if (const char* xdg_cache = getenv("XDG_CACHE_HOME"); xdg_cache && *xdg_cache)
+        return std::filesystem::path(xdg_cache) / "cfxs-build" / "git";
+#ifdef WINDOWS_BUILD
+    if (const char* local_app_data = getenv("LOCALAPPDATA"); local_app_data && *local_app_data)
+        return std::filesystem::path(local_app_data) / "cfxs-build" / "git";
+#else
+    if (const char* home = getenv("HOME"); home && *home)
+        return std::filesystem::path(home) / ".cache" / "cfxs-build" / "git";
+#endif
+    return {};
+}
+
+std::filesystem::path GitMirrorCache::get_mirror_path(const std::string& url) const {
+    // readable name + hash of full url (same repository name on different hosts)
+    const auto name = std::filesystem::path(url).stem().string();
+    return m_directory / fmt::format("{}-{:016x}.git", name, HashUtils::fnv1a(url));
+}
+
+std::filesystem::path GitMirrorCache::get_mirror(const std::string& url) {
+    const auto mirror_path = get_mirror_path(url);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_used.insert(mirror_path.string()).second)
+            return mirror_path; // already fetched in this run
+    }
+
+    try {
+        if (std::filesystem::exists(mirror_path)) {
+            Log.trace("Fetch git mirror [{}]\n    ({})", mirror_path, url);
+            GIT(mirror_path).fetch();
+        } else {
+            Log.info("Create git mirror \"{}\"", mirror_path);
+            std::filesystem::create_directories(m_directory);
+
+            // clone next to final location and move - other processes never see an incomplete mirror
+            const auto temp_path = mirror_path.string() + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+            std::filesystem::remove_all(temp_path);
+            if (!GIT::clone_mirror(temp_path, url)) {
+                std::filesystem::remove_all(temp_path);
+                throw std::runtime_error("git clone failed");
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(temp_path, mirror_path, ec);
+            if (ec) {
+                // created by another process in the meantime
+                std::filesystem::remove_all(temp_path);
+                if (!std::filesystem::exists(mirror_path))
+                    throw std::runtime_error(ec.message());
+            }
+        }
+
+        std::ofstream(mirror_path / LAST_USED_FILE, std::ios::trunc) << url << "\n";
+    } catch (const std::exception& e) {
+        Log.warn("Git mirror not available for \"{}\" - cloning without mirror ({})", url, e.what());
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_used.erase(mirror_path.string());
+        return {};
+    }
+
+    return mirror_path;
+}
+
+void GitMirrorCache::add_checkout(const std::string& url, const std::filesystem::path& checkout_path) {
+    const auto mirror_path = get_mirror_path(url);
+    std::error_code ec;
+    const auto path = std::filesystem::weakly_canonical(checkout_path, ec).string();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_used.insert(mirror_path.string());
+
+    const auto checkouts = read_lines(mirror_path / CHECKOUTS_FILE);
+    if (std::find(checkouts.begin(), checkouts.end(), path) == checkouts.end())
+        std::ofstream(mirror_path / CHECKOUTS_FILE, std::ios::app) << path << "\n";
+}
+
+bool GitMirrorCache::have_checkouts(const std::filesystem::path& mirror_path) const {
+    const auto checkouts = read_lines(mirror_path / CHECKOUTS_FILE);
+
+    std::vector<std::string> existing;
+    for (const auto& checkout : checkouts) {
+        if (uses_mirror(checkout, mirror_path))
+            existing.push_back(checkout);
+    }
+
+    if (existing.size() != checkouts.size()) {
+        // write to temporary file - other processes may read the list at the same time
+        const auto temp_path = mirror_path / (std::string(CHECKOUTS_FILE) + ".tmp");
+        {
+            std::ofstream file(temp_path, std::ios::trunc);
+            for (const auto& checkout : existing) {
+                file << checkout << "\n";
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp_path, mirror_path / CHECKOUTS_FILE, ec);
+    }
+
+    return !existing.empty();
+}
+
+void GitMirrorCache::evict() {
+    if (!std::filesystem::exists(m_directory))
+        return;
+
+    struct Mirror {
+        std::filesystem::path path;
+        std::filesystem::file_time_type last_used;
+        uint64_t size;
+    };
+
+    std::vector<Mirror> mirrors;
+    uint64_t total_size = 0;
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, ec)) {
+        if (!entry.is_directory() || entry.path().extension() != ".git")
+            continue;
+
+        Mirror mirror{entry.path(), std::filesystem::last_write_time(entry.path() / LAST_USED_FILE, ec), 0};
+        if (ec)
+            mirror.last_used = std::filesystem::last_write_time(entry.path(), ec);
+
+        for (const auto& file : std::filesystem::recursive_directory_iterator(entry.path(), ec)) {
+            if (file.is_regular_file(ec))
+                mirror.size += file.file_size(ec);
+        }
+
+        total_size += mirror.size;
+        mirrors.push_back(std::move(mirror));
+    }
+
+    if (total_size <= m_max_size_bytes)
+        return;
+
+    std::sort(mirrors.begin(), mirrors.end(), [](const Mirror& a, const Mirror& b) {
+        return a.last_used < b.last_used;
+    });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& mirror : mirrors) {
+        if (total_size <= m_max_size_bytes)
+            break;
+        if (m_used.contains(mirror.path.string()))
+            continue;
+        if (have_checkouts(mirror.path)) {
+            Log.trace("Keep git mirror \"{}\" - used by checkouts", mirror.path);
+            continue;
+        }
+
+        Log.info("Remove git mirror \"{}\" ({:.1f} MB) - cache size limit", mirror.path, mirror.size / 1024.0 / 1024.0);
+        std::filesystem::remove_all(mirror.path, ec);
+        if (!ec)
+            total_size -= mirror.size;
+    }
+}
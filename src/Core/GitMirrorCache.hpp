@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+/// User-level store of bare git repositories shared by all output directories
+/// Import checkouts borrow objects from the mirror (git alternates), so every repository is downloaded and stored once per machine
+/// Least recently used mirrors are removed when the store grows above its size limit - mirrors that existing checkouts use are kept
+class GitMirrorCache {
+public:
+    /// max_size_bytes - size limit enforced by evict()
+    GitMirrorCache(const std::filesystem::path& directory, uint64_t max_size_bytes);
+
+    /// $XDG_CACHE_HOME/cfxs-build/git, ~/.cache/cfxs-build/git or %LOCALAPPDATA%/cfxs-build/git
+    /// Returns empty path if no cache location is available
+    static std::filesystem::path get_default_directory();
+
+    /// Create or fetch mirror of url (fetched at most once per run)
+    /// Returns empty path if mirror is not available - import is then cloned without mirror
+    std::filesystem::path get_mirror(const std::string& url);
+
+    /// Record checkout that borrows objects from the mirror of url
+    void add_checkout(const std::string& url, const std::filesystem::path& checkout_path);
+
+    /// Remove least recently used mirrors until the store is below the size limit
+    /// Mirrors used in this run or by existing checkouts are never removed
+    void evict();
+
+private:
+    std::filesystem::path get_mirror_path(const std::string& url) const;
+
+    /// Drop recorded checkouts that do not exist anymore or use another mirror - return true if any are left
+    bool have_checkouts(const std::filesystem::path& mirror_path) const;
+
+private:
+    std::filesystem::path m_directory;
+    uint64_t m_max_size_bytes;
+
+    std::mutex m_mutex;
+    std::unordered_set<std::string> m_used; // mirror paths used in this run
+};
@@ -7,11 +7,76 @@ public:
     // Flag: --no-git-update
     static bool skip_git_import_update();
 
+    // Move git imports to the head of their branch and update cfxs.lock
+    // Default = false (imports in cfxs.lock are checked out at their locked commit)
+    // Flag: --update-imports
+    static bool update_imports();
+
+    // Do not run git for imports - use existing checkouts and warn if they differ from cfxs.lock
+    // Default = false
+    // Flag: --offline (implied by --frozen)
+    static bool offline_imports();
+
+    // Do not run git for imports - fail if a checkout is missing or differs from cfxs.lock
+    // Default = false
+    // Flag: --frozen
+    static bool frozen_imports();
+
+    // Size limit of shared git import mirror store in MB
+    // Default = 2048 (0 = do not use mirror store)
+    // Flag: --git-cache-size <MB>
+    static int git_cache_size_mb();
+
     // How many treads to use for builds
     // Default = -1 (number of available threads)
-    // Flag: -j<n>
+    // Flag: --parallel <n> (can be larger than number of available threads)
     static int number_of_worker_threads();
 
+    // Do not start new jobs if load average is above this value
+    // Default = 0 (no limit)
+    // Flag: -l <load>
+    static double max_load_average();
+
+    // Continue building independent jobs after a job failed
+    // Default = false (stop and terminate running jobs on first failure)
+    // Flag: -k, --keep-going
+    static bool keep_going();
+
+    // Lower number of parallel jobs while the system is under memory pressure
+    // Default = false
+    // Flag: --adaptive-jobs
+    static bool adaptive_jobs();
+
+    // Join make jobserver or act as jobserver for child processes
+    // Default = true
+    // Flag: --no-jobserver
+    static bool use_jobserver();
+
+    // Compare content hashes of sources and headers with a changed modified time before rebuilding
+    // Default = false
+    // Flag: --content-hash
+    static bool content_hash();
+
+    // Compare objects without debug sections - archives and executables keep outdated debug info if only it changed
+    // Default = false
+    // Flag: --ignore-debug-changes
+    static bool ignore_debug_changes();
+
+    // Create components from the saved build plan instead of executing the scripts if nothing they read has changed
+    // Default = true
+    // Flag: --no-build-plan
+    static bool use_build_plan();
+
+    // Keep running after the build and build again when sources, headers or scripts change
+    // Default = false
+    // Flag: --watch
+    static bool watch();
+
+    // Keep the configured project in memory and build for --connect clients
+    // Default = false
+    // Flag: --daemon
+    static bool daemon();
+
     // Generate compile_commands.json
     // Default = false
     // Flag: -c
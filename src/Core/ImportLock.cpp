@@ -0,0 +1,60 @@
+#include "ImportLock.hpp"
+#include <fstream>
+#include <sstream>
+
+static constexpr const char* LOCK_FILE_HEADER = "# cfxs-build import lock - <url> <commit>";
+
+ImportLock::ImportLock(const std::filesystem::path& path) : m_path(path) {}
+
+void ImportLock::load() {
+    std::ifstream file(m_path);
+    if (!file.is_open())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream entry(line);
+        std::string url;
+        std::string commit;
+        if (entry >> url >> commit) {
+            m_locked[url] = commit;
+        } else {
+            Log.warn("Ignoring invalid line in \"{}\": {}", m_path, line);
+        }
+    }
+}
+
+void ImportLock::save() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_resolved == m_locked)
+        return;
+
+    std::ofstream file(m_path, std::ios::trunc);
+    if (!file.is_open()) {
+        Log.error("Failed to open \"{}\" for writing", m_path);
+        throw std::runtime_error("Failed to write import lock file");
+    }
+
+    file << LOCK_FILE_HEADER << "\n";
+    for (const auto& [url, commit] : m_resolved) {
+        file << url << " " << commit << "\n";
+    }
+
+    Log.trace("Updated {}", m_path);
+    m_locked = m_resolved;
+}
+
+std::string ImportLock::get_commit(const std::string& url) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_locked.find(url);
+    return it != m_locked.end() ? it->second : "";
+}
+
+void ImportLock::set_commit(const std::string& url, const std::string& commit) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_resolved[url] = commit;
+}
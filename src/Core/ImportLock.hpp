@@ -0,0 +1,30 @@
+#pragma once
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+
+/// cfxs.lock - resolved commit of every import_git url
+class ImportLock {
+public:
+    ImportLock(const std::filesystem::path& path);
+
+    void load();
+
+    /// Write imports resolved in this run if anything changed
+    void save();
+
+    /// Locked commit of url, empty if url is not locked
+    std::string get_commit(const std::string& url) const;
+
+    /// Record resolved commit of url
+    void set_commit(const std::string& url, const std::string& commit);
+
+    const std::filesystem::path& get_path() const { return m_path; }
+
+private:
+    std::filesystem::path m_path;
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::string> m_locked;   // loaded from file
+    std::map<std::string, std::string> m_resolved; // resolved in this run
+};
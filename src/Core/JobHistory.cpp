@@ -0,0 +1,136 @@
+#include "JobHistory.hpp"
+#include <cstring>
+#include <fstream>
+
+// file layout: magic, entry count, [key, entry] * count
+static constexpr char FILE_MAGIC[8] = {'C', 'F', 'X', 'S', 'J', 'H', '0', '3'};
+
+JobHistory::JobHistory(const std::filesystem::path& path) : m_path(path) {}
+
+void JobHistory::load() {
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file.is_open())
+        return;
+
+    char magic[sizeof(FILE_MAGIC)];
+    uint64_t count = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!file || std::memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        Log.warn("Ignoring invalid job history file \"{}\"", m_path);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t key;
+        Entry entry;
+        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+        file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+        if (!file) {
+            Log.warn("Ignoring truncated job history file \"{}\"", m_path);
+            m_entries.clear();
+            return;
+        }
+        m_entries[key] = entry;
+    }
+
+    Log.trace("Loaded {} job history entries", m_entries.size());
+}
+
+void JobHistory::save() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // age entries of jobs that were not part of this build
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        auto& entry = it->second;
+        if (m_used_keys.contains(it->first)) {
+            entry.unused_builds = 0;
+        } else if (++entry.unused_builds > MAX_UNUSED_BUILDS) {
+            it = m_entries.erase(it);
+            m_modified = true;
+            continue;
+        } else {
+            m_modified = true;
+        }
+        ++it;
+    }
+    m_used_keys.clear();
+
+    if (!m_modified)
+        return;
+
+    // write to temporary file - an interrupted save must not leave a truncated history
+    auto temp_path = m_path;
+    temp_path += ".tmp";
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        Log.warn("Failed to write job history file \"{}\"", m_path);
+        return;
+    }
+
+    const uint64_t count = m_entries.size();
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& [key, entry] : m_entries) {
+        file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    file.close();
+
+    std::error_code ec;
+    if (file)
+        std::filesystem::rename(temp_path, m_path, ec);
+    if (!file || ec) {
+        Log.warn("Failed to write job history file \"{}\"", m_path);
+        std::filesystem::remove(temp_path, ec);
+        return;
+    }
+
+    m_modified = false;
+}
+
+uint32_t JobHistory::get_duration(uint64_t key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_used_keys.insert(key);
+    const auto it = m_entries.find(key);
+    return it != m_entries.end() ? it->second.duration_ms : 0;
+}
+
+uint32_t JobHistory::get_peak_memory_kb(uint64_t key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_used_keys.insert(key);
+    const auto it = m_entries.find(key);
+    return it != m_entries.end() ? it->second.peak_memory_kb : 0;
+}
+
+uint32_t JobHistory::get_average_duration() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.empty())
+        return 0;
+
+    uint64_t total = 0;
+    for (const auto& [key, entry] : m_entries) {
+        total += entry.duration_ms;
+    }
+    return total / m_entries.size();
+}
+
+uint32_t JobHistory::get_average_peak_memory_kb() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.empty())
+        return 0;
+
+    uint64_t total = 0;
+    for (const auto& [key, entry] : m_entries) {
+        total += entry.peak_memory_kb;
+    }
+    return total / m_entries.size();
+}
+
+void JobHistory::record(uint64_t key, uint32_t duration_ms, uint32_t peak_memory_kb) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[key] = {duration_ms, peak_memory_kb, 0};
+    m_used_keys.insert(key);
+    m_modified = true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+/// Job durations and memory usage of previous builds
+/// Keyed by job fingerprint (source path + command line for compile jobs)
+/// Used to start the longest dependency chains and heaviest jobs first
+/// Entries that are not used by MAX_UNUSED_BUILDS builds in a row are dropped (old flags, removed sources)
+class JobHistory {
+public:
+    struct Entry {
+        uint32_t duration_ms;
+        uint32_t peak_memory_kb; // largest peak RSS of the processes of the job
+        uint32_t unused_builds;  // number of builds since the job was last looked up or recorded
+    };
+
+    static constexpr uint32_t MAX_UNUSED_BUILDS = 16;
+
+public:
+    JobHistory(const std::filesystem::path& path);
+
+    void load();
+    void save();
+
+    /// Get duration of job from a previous build, 0 if unknown
+    uint32_t get_duration(uint64_t key) const;
+
+    /// Get peak memory usage of job from a previous build, 0 if unknown
+    uint32_t get_peak_memory_kb(uint64_t key) const;
+
+    /// Average duration of all known jobs, 0 if no jobs are known
+    uint32_t get_average_duration() const;
+
+    /// Average peak memory usage of all known jobs, 0 if no jobs are known
+    uint32_t get_average_peak_memory_kb() const;
+
+    void record(uint64_t key, uint32_t duration_ms, uint32_t peak_memory_kb);
+
+private:
+    std::filesystem::path m_path;
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    mutable std::unordered_set<uint64_t> m_used_keys; // looked up or recorded in this build
+    bool m_modified = false;
+};
@@ -0,0 +1,190 @@
+#include "JobPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+// how often the load average is checked while a job is waiting for load to drop
+static constexpr auto LOAD_POLL_INTERVAL = std::chrono::milliseconds(100);
+
+// adaptive mode - how often system memory state is sampled
+// (/proc/pressure avg10 is a 10s average - faster reaction would only overshoot)
+static constexpr auto ADAPTIVE_SAMPLE_INTERVAL = std::chrono::milliseconds(1000);
+// percentage of time tasks were stalled on memory in the last 10s
+static constexpr double HIGH_MEMORY_PRESSURE = 10.0;
+static constexpr double LOW_MEMORY_PRESSURE  = 1.0;
+// fraction of total memory that is kept free
+static constexpr double MEMORY_RESERVE_FRACTION = 0.05;
+// available memory below this fraction of total memory counts as high pressure
+static constexpr double LOW_MEMORY_FRACTION = 0.10;
+
+struct SystemMemoryState {
+    bool valid;
+    bool has_pressure; // /proc/pressure/memory is available (Linux 4.20+ with PSI enabled)
+    double pressure;   // "some" avg10
+    uint64_t available_kb;
+    uint64_t total_kb;
+    double load;
+};
+
+static SystemMemoryState read_system_memory_state() {
+    SystemMemoryState state{};
+#ifndef WINDOWS_BUILD
+    std::string line;
+
+    std::ifstream meminfo("/proc/meminfo");
+    while (std::getline(meminfo, line)) {
+        unsigned long long value;
+        if (sscanf(line.c_str(), "MemTotal: %llu kB", &value) == 1) {
+            state.total_kb = value;
+        } else if (sscanf(line.c_str(), "MemAvailable: %llu kB", &value) == 1) {
+            state.available_kb = value;
+            break;
+        }
+    }
+    state.valid = state.total_kb != 0;
+
+    std::ifstream pressure("/proc/pressure/memory");
+    if (std::getline(pressure, line))
+        state.has_pressure = sscanf(line.c_str(), "some avg10=%lf", &state.pressure) == 1;
+
+    std::ifstream loadavg("/proc/loadavg");
+    loadavg >> state.load;
+#endif
+    return state;
+}
+
+JobPool::JobPool(int max_jobs, double max_load, bool adaptive) :
+    m_max_jobs(max_jobs < 1 ? 1 : max_jobs),
+    m_max_load(max_load),
+    m_adaptive(adaptive),
+    m_adaptive_limit(m_max_jobs),
+    m_lowest_adaptive_limit(m_max_jobs) {
+    Log.trace("Job pool: {} jobs{}{}",
+              m_max_jobs,
+              m_max_load > 0 ? fmt::format(", max load {:.2f}", m_max_load) : "",
+              m_adaptive ? ", adaptive" : "");
+}
+
+JobPool::Slot JobPool::acquire(uint64_t expected_memory_kb) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    bool load_throttled   = false;
+    bool memory_throttled = false;
+    const auto throttle   = [&](bool& throttled, int& counter) {
+        if (!throttled) {
+            throttled = true;
+            counter++;
+        }
+        m_cv.wait_for(lock, LOAD_POLL_INTERVAL);
+    };
+
+    while (true) {
+        if (m_adaptive)
+            update_adaptive_limit();
+
+        if (m_running < m_adaptive_limit) {
+            // always allow at least one job to run, otherwise the build would never finish on a loaded system
+            if (m_running == 0)
+                break;
+
+            if (!load_allows_new_job()) {
+                throttle(load_throttled, m_load_throttle_count);
+            } else if (m_adaptive && !memory_allows_new_job(expected_memory_kb)) {
+                throttle(memory_throttled, m_memory_throttle_count);
+            } else {
+                break;
+            }
+        } else if (m_running < m_max_jobs) {
+            // held back by adaptive limit
+            throttle(memory_throttled, m_memory_throttle_count);
+        } else {
+            m_cv.wait(lock);
+        }
+    }
+
+    m_running++;
+
+    // count memory of the new job as used until the next sample sees it
+    if (m_adaptive)
+        m_available_memory_kb -= std::min(m_available_memory_kb, expected_memory_kb);
+
+    // the first job runs on the implicit token of this process, others need a jobserver token
+    const bool implicit_token = !m_implicit_token_used;
+    m_implicit_token_used     = true;
+    lock.unlock();
+
+    if (implicit_token)
+        return Slot(this, true);
+    return Slot(this, false, Jobserver::acquire());
+}
+
+void JobPool::release(bool implicit_token) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running--;
+    if (implicit_token)
+        m_implicit_token_used = false;
+    m_cv.notify_one();
+}
+
+bool JobPool::load_allows_new_job() const {
+    if (m_max_load <= 0)
+        return true;
+
+#ifdef WINDOWS_BUILD
+    return true;
+#else
+    double load = 0;
+    if (getloadavg(&load, 1) != 1)
+        return true;
+    return load < m_max_load;
+#endif
+}
+
+bool JobPool::memory_allows_new_job(uint64_t expected_memory_kb) {
+    if (m_total_memory_kb == 0)
+        return true; // no memory information
+
+    const auto reserve_kb = (uint64_t)(m_total_memory_kb * MEMORY_RESERVE_FRACTION);
+    return m_available_memory_kb >= expected_memory_kb + reserve_kb;
+}
+
+void JobPool::update_adaptive_limit() {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_last_sample_time < ADAPTIVE_SAMPLE_INTERVAL)
+        return;
+    m_last_sample_time = now;
+
+    const auto state = read_system_memory_state();
+    if (!state.valid)
+        return;
+
+    m_available_memory_kb = state.available_kb;
+    m_total_memory_kb     = state.total_kb;
+
+    const bool low_memory    = state.available_kb < state.total_kb * LOW_MEMORY_FRACTION;
+    const bool high_pressure = low_memory || (state.has_pressure && state.pressure >= HIGH_MEMORY_PRESSURE);
+    const bool low_pressure  = !low_memory && (!state.has_pressure || state.pressure < LOW_MEMORY_PRESSURE);
+
+    const auto previous_limit = m_adaptive_limit;
+    if (high_pressure) {
+        // back off quickly, below the number of currently running jobs
+        m_adaptive_limit = std::max(1, std::min(m_adaptive_limit, m_running) * 3 / 4);
+    } else if (low_pressure && state.load < m_max_jobs) {
+        // recover slowly
+        m_adaptive_limit = std::min(m_max_jobs, m_adaptive_limit + 1);
+    }
+
+    if (m_adaptive_limit != previous_limit) {
+        m_lowest_adaptive_limit = std::min(m_lowest_adaptive_limit, m_adaptive_limit);
+        Log.trace("Adaptive job limit {} -> {} (memory pressure {:.1f}%, {} MiB available, load {:.2f})",
+                  previous_limit,
+                  m_adaptive_limit,
+                  state.pressure,
+                  state.available_kb / 1024,
+                  state.load);
+        m_cv.notify_all();
+    }
+}
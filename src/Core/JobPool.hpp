@@ -0,0 +1,73 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "Jobserver.hpp"
+
+/// Admission control for build jobs that spawn processes
+/// Limits the exact number of concurrently running jobs and optionally
+/// stops starting new jobs while the system load average is above a limit (like make -l)
+/// In adaptive mode the job limit is lowered while the system is under memory pressure and raised again when pressure drops
+/// Jobs running in addition to the first one also hold a jobserver token
+class JobPool {
+public:
+    class Slot {
+    public:
+        Slot(JobPool* pool, bool implicit_token, Jobserver::Token&& token = {}) :
+            m_pool(pool), m_implicit_token(implicit_token), m_token(std::move(token)) {}
+        Slot(Slot&& other) : m_pool(other.m_pool), m_implicit_token(other.m_implicit_token), m_token(std::move(other.m_token)) {
+            other.m_pool = nullptr;
+        }
+        Slot(const Slot&) = delete;
+        ~Slot() {
+            if (m_pool)
+                m_pool->release(m_implicit_token);
+        }
+
+    private:
+        JobPool* m_pool;
+        bool m_implicit_token;
+        Jobserver::Token m_token;
+    };
+
+public:
+    /// max_jobs - number of jobs allowed to run at the same time (can be more than hardware threads)
+    /// max_load - do not start new jobs if load average is above this value and other jobs are running (0 = no limit)
+    /// adaptive - limit jobs by memory pressure and available memory (Linux only)
+    JobPool(int max_jobs, double max_load = 0, bool adaptive = false);
+
+    /// Block until a job is allowed to start
+    /// expected_memory_kb - expected peak memory usage of the job (used in adaptive mode, 0 = unknown)
+    Slot acquire(uint64_t expected_memory_kb = 0);
+
+    int get_max_jobs() const { return m_max_jobs; }
+    int get_load_throttle_count() const { return m_load_throttle_count; }
+    int get_memory_throttle_count() const { return m_memory_throttle_count; }
+    int get_lowest_adaptive_limit() const { return m_lowest_adaptive_limit; }
+
+private:
+    void release(bool implicit_token);
+    bool load_allows_new_job() const;
+    bool memory_allows_new_job(uint64_t expected_memory_kb);
+    void update_adaptive_limit();
+
+private:
+    int m_max_jobs;
+    double m_max_load;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    int m_running              = 0;
+    bool m_implicit_token_used = false;
+    int m_load_throttle_count  = 0;
+
+    // adaptive mode
+    bool m_adaptive;
+    int m_adaptive_limit;
+    int m_lowest_adaptive_limit;
+    int m_memory_throttle_count = 0;
+    std::chrono::steady_clock::time_point m_last_sample_time;
+    uint64_t m_available_memory_kb = 0; // last sample minus expected usage of jobs started since
+    uint64_t m_total_memory_kb     = 0;
+};
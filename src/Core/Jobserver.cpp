@@ -0,0 +1,153 @@
+#include "Jobserver.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <string_view>
+#ifndef WINDOWS_BUILD
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+// cleared by workers in acquire() if the jobserver fails
+static std::atomic<bool> s_active = false;
+static bool s_is_client           = false;
+static int s_read_fd              = -1;
+static int s_write_fd             = -1;
+
+bool Jobserver::is_active() { return s_active; }
+bool Jobserver::is_client() { return s_is_client; }
+
+#ifndef WINDOWS_BUILD
+// Open own file description of an inherited pipe, so it can be made non-blocking without affecting make
+static int reopen_nonblocking(int fd) {
+    const auto path = "/proc/self/fd/" + std::to_string(fd);
+    return open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+}
+
+static bool is_valid_fd(int fd) { return fd >= 0 && fcntl(fd, F_GETFD) != -1; }
+
+// Parse "--jobserver-auth=" (or pre 4.2 "--jobserver-fds=") value from MAKEFLAGS
+static std::string get_jobserver_auth(std::string_view makeflags) {
+    std::string auth;
+    for (const auto key : {std::string_view("--jobserver-auth="), std::string_view("--jobserver-fds=")}) {
+        // last occurrence wins
+        const auto pos = makeflags.rfind(key);
+        if (pos == std::string_view::npos)
+            continue;
+        const auto value = makeflags.substr(pos + key.length());
+        auth             = std::string(value.substr(0, value.find(' ')));
+        break;
+    }
+    return auth;
+}
+
+static bool join_jobserver(const std::string& auth) {
+    if (auth.starts_with("fifo:")) {
+        const auto path = auth.substr(5);
+        s_read_fd       = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        s_write_fd      = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        if (s_read_fd < 0 || s_write_fd < 0) {
+            Log.warn("Failed to open jobserver fifo \"{}\"", path);
+            return false;
+        }
+        return true;
+    }
+
+    int r = -1;
+    int w = -1;
+    if (sscanf(auth.c_str(), "%d,%d", &r, &w) != 2 || !is_valid_fd(r) || !is_valid_fd(w)) {
+        // make did not pass the pipe to this process (command not marked with + in makefile)
+        Log.warn("Jobserver \"{}\" from MAKEFLAGS is not available", auth);
+        return false;
+    }
+
+    s_read_fd  = reopen_nonblocking(r);
+    s_write_fd = w;
+    if (s_read_fd < 0) {
+        Log.warn("Failed to open jobserver pipe");
+        return false;
+    }
+    return true;
+}
+
+static bool create_jobserver(int max_jobs) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        Log.warn("Failed to create jobserver pipe");
+        return false;
+    }
+
+    // the first job runs with the implicit token of this process
+    const std::string tokens(max_jobs - 1, '+');
+    if (!tokens.empty() && write(fds[1], tokens.data(), tokens.size()) != (ssize_t)tokens.size()) {
+        Log.warn("Failed to fill jobserver pipe");
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    // children get the pipe through MAKEFLAGS (pipe style is understood by make 4.x and newer)
+    const auto makeflags = fmt::format(" -j{} --jobserver-auth={},{}", max_jobs, fds[0], fds[1]);
+    setenv("MAKEFLAGS", makeflags.c_str(), 1);
+
+    s_read_fd  = reopen_nonblocking(fds[0]);
+    s_write_fd = fds[1];
+    if (s_read_fd < 0) {
+        Log.warn("Failed to open jobserver pipe");
+        return false;
+    }
+    return true;
+}
+
+void Jobserver::initialize(int max_jobs) {
+    const char* env_makeflags = getenv("MAKEFLAGS");
+    const auto auth           = get_jobserver_auth(env_makeflags ? env_makeflags : "");
+
+    if (!auth.empty()) {
+        s_active    = join_jobserver(auth);
+        s_is_client = s_active;
+        if (s_active)
+            Log.trace("Joined jobserver \"{}\"", auth);
+    } else {
+        s_active = create_jobserver(max_jobs);
+        if (s_active)
+            Log.trace("Created jobserver with {} tokens", max_jobs);
+    }
+}
+
+Jobserver::Token Jobserver::acquire() {
+    if (!s_active)
+        return {};
+
+    while (true) {
+        char token;
+        const auto n = read(s_read_fd, &token, 1);
+        if (n == 1)
+            return Token(token);
+
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            Log.warn("Jobserver read failed ({}) - continuing without jobserver", errno);
+            s_active = false;
+            return {};
+        }
+
+        // wait for a token to be returned by any process sharing the jobserver
+        pollfd pfd = {s_read_fd, POLLIN, 0};
+        poll(&pfd, 1, -1);
+    }
+}
+
+void Jobserver::release(char token) {
+    while (write(s_write_fd, &token, 1) < 0 && errno == EINTR) {
+    }
+}
+#else
+void Jobserver::initialize(int) {
+    // make jobserver on Windows uses named semaphores - not supported
+}
+
+Jobserver::Token Jobserver::acquire() { return {}; }
+
+void Jobserver::release(char) {}
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+
+/// GNU make jobserver
+/// Client: if started from make (MAKEFLAGS contains --jobserver-auth), every job after the first one takes a token from make
+/// Server: otherwise a jobserver with max_jobs tokens is created and exported to child processes through MAKEFLAGS,
+///         so make runs in after-build commands share the job budget of this build
+class Jobserver {
+public:
+    class Token {
+    public:
+        Token() = default;
+        Token(char value) : m_value(value), m_valid(true) {}
+        Token(Token&& other) : m_value(other.m_value), m_valid(other.m_valid) { other.m_valid = false; }
+        Token(const Token&) = delete;
+        ~Token() {
+            if (m_valid)
+                Jobserver::release(m_value);
+        }
+
+    private:
+        char m_value = 0;
+        bool m_valid = false;
+    };
+
+public:
+    /// Join jobserver from MAKEFLAGS or create a new one with max_jobs tokens
+    static void initialize(int max_jobs);
+
+    static bool is_active();
+    static bool is_client();
+
+    /// Block until a token is available
+    /// Only needed for jobs running in addition to the first job (implicit token of this process)
+    static Token acquire();
+
+private:
+    static void release(char token);
+};
@@ -14,7 +14,7 @@ static std::string to_string(Linker::Type type) {
 
 Linker::~Linker() { Log.trace("Delete Linker"); }
 
-Linker::Linker(const std::string& linker, bool known_good, const std::string& known_version) : m_location(linker) {
+Linker::Linker(const std::string& linker, bool known_good, const std::string& known_version) : m_location(linker), m_executable_path(ProcessSupervisor::resolve_program(linker)) {
     Log.trace("Create linker \"{}\"", known_version, get_location());
 
     if (!known_good && !is_valid_program(get_location())) {
@@ -22,7 +22,8 @@ Linker::Linker(const std::string& linker, bool known_good, const std::string& kn
         throw std::runtime_error("Linker not found");
     }
 
-    const auto linker_version_string = known_version.empty() ? get_program_version_string(get_location()) : known_version;
+    m_version_string                  = known_version.empty() ? get_program_version_string(get_executable_path()) : known_version;
+    const auto& linker_version_string = m_version_string;
 
     if (linker_version_string.contains("GNU") || linker_version_string.contains("gcc")) {
         m_type = Type::GNU;
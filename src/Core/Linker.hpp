@@ -10,6 +10,8 @@ public:
 
     Type get_type() const { return m_type; }
     const std::string& get_location() const { return m_location; }
+    const std::string& get_executable_path() const { return m_executable_path; }
+    const std::string& get_version_string() const { return m_version_string; }
 
     void load_link_flags(std::vector<std::string>& args,
                          const std::filesystem::path& output_file,
@@ -22,5 +24,7 @@ public:
 private:
     Type m_type;
     std::string m_location;
+    std::string m_executable_path; // absolute path of m_location (resolved once)
+    std::string m_version_string;
     std::vector<std::string> m_flags;
 };
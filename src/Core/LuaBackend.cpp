@@ -67,6 +67,11 @@ const char* LuaBackend::get_script_help_string(HelpEntry he) {
             return "\n" ANSI_GREEN "[Usage] " CODE_COLOR "component:" FUNCTION_COLOR "set_linker_script" CODE_COLOR "("   //
                 ARG_COLOR "path" CODE_COLOR ")\n"                                                                         //
                 ARG_COLOR "    path: " ANSI_RESET "\"./path/to/linkerscript.ld\"" ANSI_GRAY " (absolute/relative)" ANSI_RESET "\n";
+        case HelpEntry::COMPONENT_SET_THIN_ARCHIVE:
+            return "\n" ANSI_GREEN "[Usage] " CODE_COLOR "library:" FUNCTION_COLOR "set_thin_archive" CODE_COLOR "(" //
+                ARG_COLOR "enabled" CODE_COLOR ")\n"                                                                     //
+                ARG_COLOR "    enabled: " ANSI_RESET "true" ANSI_YELLOW " or " ANSI_RESET "false" ANSI_GRAY
+                   " (archive references objects in output directory - GNU/LLVM archiver)" ANSI_RESET "\n";
         case HelpEntry::SET_LINKER:
             return "\n" ANSI_GREEN "[Usage] " FUNCTION_COLOR "set_linker" CODE_COLOR "(" //
                 ARG_COLOR "path" CODE_COLOR ")\n"                                        //
@@ -26,6 +26,7 @@ public:
         COMPONENT_ADD_COMPILE_OPTIONS,
         COMPONENT_ADD_LINK_OPTIONS,
         COMPONENT_SET_LINKER_SCRIPT,
+        COMPONENT_SET_THIN_ARCHIVE,
         COMPONENT_CREATE_PRECOMPILED_HEADER,
         GLOBAL_ADD_INCLUDE_PATHS,
         GLOBAL_ADD_DEFINITIONS,
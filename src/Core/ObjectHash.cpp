@@ -0,0 +1,137 @@
+#include "ObjectHash.hpp"
+#include <bit>
+#include <cstring>
+#include <string>
+#include "Core/ContentHashCache.hpp"
+#include "MappedFile.hpp"
+
+// ELF layout - 32 and 64 bit only differ in the size of address fields
+template<typename Addr>
+struct ElfHeader {
+    uint8_t ident[16];
+    uint16_t type;
+    uint16_t machine;
+    uint32_t version;
+    Addr entry;
+    Addr phoff;
+    Addr shoff;
+    uint32_t flags;
+    uint16_t ehsize;
+    uint16_t phentsize;
+    uint16_t phnum;
+    uint16_t shentsize;
+    uint16_t shnum;
+    uint16_t shstrndx;
+};
+
+template<typename Addr>
+struct ElfSectionHeader {
+    uint32_t name;
+    uint32_t type;
+    Addr flags;
+    Addr addr;
+    Addr offset;
+    Addr size;
+    uint32_t link;
+    uint32_t info;
+    Addr addralign;
+    Addr entsize;
+};
+
+static constexpr uint8_t ELF_CLASS_32     = 1;
+static constexpr uint8_t ELF_CLASS_64     = 2;
+static constexpr uint8_t ELF_DATA_LSB     = 1;
+static constexpr uint8_t ELF_DATA_MSB     = 2;
+static constexpr uint32_t SHT_NOBITS_TYPE = 8;
+
+/// Debug info and its relocations (.debug_*, compressed .zdebug_*, LTO debug sections)
+static bool is_debug_section(std::string_view name) {
+    if (name.starts_with(".rela"))
+        name.remove_prefix(5);
+    else if (name.starts_with(".rel"))
+        name.remove_prefix(4);
+    return name.starts_with(".debug") || name.starts_with(".zdebug") || name.starts_with(".gnu.debuglto_");
+}
+
+/// Hash of non-debug section names, types, flags and contents - 0 if the section table is invalid
+/// File offsets are not hashed, they move when debug sections change size
+template<typename Addr>
+static uint64_t hash_elf_sections(std::string_view data) {
+    ElfHeader<Addr> header;
+    if (data.size() < sizeof(header))
+        return 0;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.shentsize != sizeof(ElfSectionHeader<Addr>) || header.shstrndx >= header.shnum || header.shoff > data.size() ||
+        (data.size() - header.shoff) / sizeof(ElfSectionHeader<Addr>) < header.shnum)
+        return 0;
+
+    const auto get_section = [&](uint16_t index) {
+        ElfSectionHeader<Addr> section;
+        std::memcpy(&section, data.data() + header.shoff + index * sizeof(section), sizeof(section));
+        return section;
+    };
+    const auto get_content = [&](const ElfSectionHeader<Addr>& section, std::string_view& content) {
+        if (section.type == SHT_NOBITS_TYPE) {
+            content = {};
+            return true;
+        }
+        if (section.offset > data.size() || data.size() - section.offset < section.size)
+            return false;
+        content = data.substr(section.offset, section.size);
+        return true;
+    };
+
+    std::string_view names;
+    if (!get_content(get_section(header.shstrndx), names))
+        return 0;
+
+    // header without offsets, then [name, type, flags, size, content hash] of every kept section
+    std::string digest;
+    digest.append(reinterpret_cast<const char*>(header.ident), sizeof(header.ident));
+    digest.append(reinterpret_cast<const char*>(&header.type), sizeof(header.type));
+    digest.append(reinterpret_cast<const char*>(&header.machine), sizeof(header.machine));
+    digest.append(reinterpret_cast<const char*>(&header.flags), sizeof(header.flags));
+
+    for (uint16_t i = 0; i < header.shnum; i++) {
+        const auto section = get_section(i);
+        if (section.name >= names.size())
+            return 0;
+        const auto name = names.substr(section.name, names.find('\0', section.name) - section.name); // rest of table if unterminated
+        if (is_debug_section(name))
+            continue;
+
+        std::string_view content;
+        if (!get_content(section, content))
+            return 0;
+
+        const uint64_t content_hash = ContentHashCache::hash(content);
+        digest.append(name);
+        digest.push_back('\0');
+        digest.append(reinterpret_cast<const char*>(&section.type), sizeof(section.type));
+        digest.append(reinterpret_cast<const char*>(&section.flags), sizeof(section.flags));
+        digest.append(reinterpret_cast<const char*>(&section.size), sizeof(section.size));
+        digest.append(reinterpret_cast<const char*>(&content_hash), sizeof(content_hash));
+    }
+
+    return ContentHashCache::hash(digest);
+}
+
+uint64_t ObjectHash::hash_without_debug_sections(std::string_view data) {
+    // only objects with the byte order of the host are parsed (cross compiled big endian objects are hashed completely)
+    constexpr uint8_t host_data = std::endian::native == std::endian::little ? ELF_DATA_LSB : ELF_DATA_MSB;
+    uint64_t hash               = 0;
+    if (data.size() > 16 && data.starts_with("\x7F" "ELF") && (uint8_t)data[5] == host_data) {
+        if ((uint8_t)data[4] == ELF_CLASS_32)
+            hash = hash_elf_sections<uint32_t>(data);
+        else if ((uint8_t)data[4] == ELF_CLASS_64)
+            hash = hash_elf_sections<uint64_t>(data);
+    }
+    return hash ? hash : ContentHashCache::hash(data);
+}
+
+uint64_t ObjectHash::get(const std::filesystem::path& object_path, bool ignore_debug_sections) {
+    const MappedFile file(object_path);
+    if (!file.is_open())
+        return 0;
+    return ignore_debug_sections ? hash_without_debug_sections(file.view()) : ContentHashCache::hash(file.view());
+}
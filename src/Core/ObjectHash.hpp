@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+/// Hash of compiled object content - archives and executables are only created again if an object hash changed
+/// ELF debug sections can be ignored: comment-only header changes move line numbers and change nothing else
+class ObjectHash {
+public:
+    /// Get hash of object file, 0 if the file can not be read
+    /// ignore_debug_sections - hash ELF objects without .debug_* sections (other formats are always hashed completely)
+    static uint64_t get(const std::filesystem::path& object_path, bool ignore_debug_sections);
+
+    /// Hash object data without debug sections - complete data if it is not a valid ELF object
+    static uint64_t hash_without_debug_sections(std::string_view data);
+};
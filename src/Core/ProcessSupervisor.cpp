@@ -0,0 +1,365 @@
+#include "ProcessSupervisor.hpp"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#ifdef WINDOWS_BUILD
+#include <subprocess.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+static std::atomic<uint64_t> s_spawn_count    = 0;
+static std::atomic<uint64_t> s_spawn_total_ns = 0;
+
+static std::atomic<bool> s_terminating = false;
+
+// build jobs run their processes synchronously on one thread - per thread peak is the peak of the current job
+static thread_local uint64_t s_thread_peak_memory_kb = 0;
+
+static std::unordered_map<std::string, std::string> s_resolved_programs;
+static std::mutex s_mutex_resolved_programs;
+
+std::string ProcessSupervisor::resolve_program(const std::string& program) {
+#ifdef WINDOWS_BUILD
+    return program; // subprocess searches PATH on Windows
+#else
+    if (program.empty() || program.contains('/'))
+        return program;
+
+    std::lock_guard<std::mutex> lock(s_mutex_resolved_programs);
+
+    const auto it = s_resolved_programs.find(program);
+    if (it != s_resolved_programs.end())
+        return it->second;
+
+    std::string resolved = program;
+
+    const char* env_path = getenv("PATH");
+    std::string_view path_list(env_path ? env_path : "");
+    while (!path_list.empty()) {
+        const auto sep = path_list.find(':');
+        const auto dir = path_list.substr(0, sep);
+        path_list      = sep == std::string_view::npos ? std::string_view{} : path_list.substr(sep + 1);
+
+        const auto candidate = std::filesystem::path(dir.empty() ? "." : dir) / program;
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(candidate, ec) && access(candidate.c_str(), X_OK) == 0) {
+            resolved = std::filesystem::absolute(candidate, ec).string();
+            break;
+        }
+    }
+
+    Log.trace("Resolve \"{}\" -> \"{}\"", program, resolved);
+    s_resolved_programs[program] = resolved;
+    return resolved;
+#endif
+}
+
+ProcessSupervisor::SpawnStatistics ProcessSupervisor::get_spawn_statistics() {
+    return {s_spawn_count.load(), s_spawn_total_ns.load()}; //
+}
+
+uint64_t ProcessSupervisor::get_thread_peak_memory_kb() {
+    return s_thread_peak_memory_kb; //
+}
+
+void ProcessSupervisor::reset_thread_peak_memory() {
+    s_thread_peak_memory_kb = 0; //
+}
+
+bool ProcessSupervisor::is_terminating() {
+    return s_terminating; //
+}
+
+void ProcessSupervisor::reset() {
+    s_terminating = false; //
+}
+
+static void record_spawn_time(std::chrono::high_resolution_clock::time_point t_start) {
+    const auto t_end = std::chrono::high_resolution_clock::now();
+    s_spawn_count++;
+    s_spawn_total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count();
+}
+
+#ifndef WINDOWS_BUILD
+extern char** environ;
+
+// Process groups of running children
+// Fixed size lock-free table so it can also be walked from a signal handler
+// Slot values: 0 = free, -1 = reserved, >0 = process group id
+static constexpr size_t MAX_TRACKED_PROCESSES = 1024;
+static std::atomic<pid_t> s_process_groups[MAX_TRACKED_PROCESSES];
+
+static void terminate_process_groups() {
+    for (auto& slot : s_process_groups) {
+        const pid_t pgid = slot.load();
+        if (pgid > 0)
+            kill(-pgid, SIGTERM);
+    }
+}
+
+// Children are not in the foreground process group of the terminal
+// Forward Ctrl+C/termination of this process to them
+static void on_termination_signal(int sig) {
+    terminate_process_groups();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void install_signal_handlers() {
+    static std::once_flag s_once;
+    std::call_once(s_once, []() {
+        for (const int sig : {SIGINT, SIGTERM, SIGHUP}) {
+            struct sigaction current {};
+            sigaction(sig, nullptr, &current);
+            if (current.sa_handler == SIG_IGN)
+                continue; // keep nohup behaviour
+
+            struct sigaction action {};
+            action.sa_handler = on_termination_signal;
+            sigemptyset(&action.sa_mask);
+            sigaction(sig, &action, nullptr);
+        }
+    });
+}
+
+// Returns slot index or -1 if all slots are in use (process is then started in the current process group)
+static int reserve_process_slot() {
+    for (size_t i = 0; i < MAX_TRACKED_PROCESSES; i++) {
+        pid_t expected = 0;
+        if (s_process_groups[i].compare_exchange_strong(expected, -1))
+            return (int)i;
+    }
+    return -1;
+}
+
+void ProcessSupervisor::terminate_all() {
+    s_terminating = true;
+    terminate_process_groups();
+}
+
+// Environment for all child processes, built once
+static char* const* get_child_environment() {
+    static std::vector<std::string> s_strings;
+    static std::vector<char*> s_environment = []() {
+        for (char** e = environ; e && *e; e++) {
+            s_strings.emplace_back(*e);
+        }
+        std::vector<char*> env;
+        for (auto& s : s_strings) {
+            env.push_back(s.data());
+        }
+        env.push_back(nullptr);
+        return env;
+    }();
+    return s_environment.data();
+}
+
+// pidfd becomes readable when the child exits - Linux 5.3+
+static int open_pidfd(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+// Read everything currently available from non-blocking fd
+// Returns false if the write end has been closed
+static bool drain_fd(int fd, std::string& output) {
+    char buf[16384];
+    while (true) {
+        const auto n = read(fd, buf, sizeof(buf));
+        if (n > 0) {
+            output.append(buf, n);
+        } else if (n == 0) {
+            return false;
+        } else if (errno == EINTR) {
+            continue;
+        } else {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+    }
+}
+
+// Wait until the child exits, collecting output as it is written
+// Grandchildren can keep the output pipe open after the child exits, so the pidfd is used to wake up on exit
+static void supervise(pid_t pid, int out_fd, std::string& output) {
+    fcntl(out_fd, F_SETFL, fcntl(out_fd, F_GETFL) | O_NONBLOCK);
+
+    const int pid_fd = open_pidfd(pid);
+
+    bool pipe_open = true;
+    bool exited    = false;
+    while (pipe_open && !exited) {
+        pollfd fds[2] = {
+            {out_fd, POLLIN, 0},
+            {pid_fd, POLLIN, 0},
+        };
+
+        if (poll(fds, pid_fd >= 0 ? 2 : 1, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR))
+            pipe_open = drain_fd(out_fd, output);
+        if (pid_fd >= 0 && (fds[1].revents & POLLIN))
+            exited = true;
+    }
+
+    // child is gone - collect everything it wrote before exiting
+    if (pipe_open)
+        drain_fd(out_fd, output);
+
+    if (pid_fd >= 0)
+        close(pid_fd);
+}
+
+std::pair<int, std::string> ProcessSupervisor::run(const std::string& program, const std::vector<std::string>& args) {
+    const auto t_start = std::chrono::high_resolution_clock::now();
+
+    const auto path = resolve_program(program);
+
+    std::vector<char*> argv;
+    argv.reserve(args.size() + 2);
+    argv.push_back(const_cast<char*>(path.c_str()));
+    for (const auto& a : args) {
+        argv.push_back(const_cast<char*>(a.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // close-on-exec so output pipes of parallel jobs do not leak into each other
+    int out_pipe[2];
+    if (pipe2(out_pipe, O_CLOEXEC) != 0) {
+        Log.error("[pipe {}] Failed to execute \"{}\"", errno, program);
+        throw std::runtime_error("Failed to execute");
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDERR_FILENO);
+
+    install_signal_handlers();
+    const int slot = reserve_process_slot();
+
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    if (slot >= 0) {
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attributes, 0); // new group with pgid = pid
+    }
+
+    // glibc posix_spawn uses vfork semantics - no page table copy of this (large) process
+    pid_t pid = 0;
+    const int res =
+        path.contains('/') ?
+            posix_spawn(&pid, path.c_str(), &actions, &attributes, argv.data(), get_child_environment()) :
+            posix_spawnp(&pid, path.c_str(), &actions, &attributes, argv.data(), get_child_environment()); // not found in cached PATH lookup
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+    close(out_pipe[1]);
+
+    if (res != 0) {
+        if (slot >= 0)
+            s_process_groups[slot] = 0;
+        close(out_pipe[0]);
+        Log.error("[create {}] Failed to execute \"{}\"", res, program);
+        throw std::runtime_error("Failed to execute");
+    }
+
+    if (slot >= 0) {
+        s_process_groups[slot] = pid;
+        // terminate_all() may have missed this process
+        if (s_terminating)
+            kill(-pid, SIGTERM);
+    }
+
+    record_spawn_time(t_start);
+
+    std::string output;
+    supervise(pid, out_pipe[0], output);
+    close(out_pipe[0]);
+
+    // free slot before the process is reaped - process group id can not be reused until then
+    if (slot >= 0)
+        s_process_groups[slot] = 0;
+
+    int status = 0;
+    struct rusage usage {};
+    while (wait4(pid, &status, 0, &usage) < 0) {
+        if (errno != EINTR) {
+            Log.error("[join {}] Failed to execute \"{}\"", errno, program);
+            throw std::runtime_error("Failed to execute");
+        }
+    }
+
+    // ru_maxrss is in KiB on Linux
+    if ((uint64_t)usage.ru_maxrss > s_thread_peak_memory_kb)
+        s_thread_peak_memory_kb = usage.ru_maxrss;
+
+    const int process_ret = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+    return {process_ret, output};
+}
+#else
+void ProcessSupervisor::terminate_all() {
+    s_terminating = true; //
+}
+
+std::pair<int, std::string> ProcessSupervisor::run(const std::string& program, const std::vector<std::string>& args) {
+    const auto t_start = std::chrono::high_resolution_clock::now();
+
+    std::vector<const char*> command_line = program.empty() ? std::vector<const char*>{} : std::vector<const char*>{program.c_str()};
+    for (const auto& a : args) {
+        command_line.push_back(a.c_str());
+    }
+    command_line.push_back(NULL);
+
+    struct subprocess_s process;
+    int res = subprocess_create(
+        command_line.data(),
+        subprocess_option_combined_stdout_stderr | subprocess_option_search_user_path | subprocess_option_inherit_environment,
+        &process);
+    if (res != 0) {
+        Log.error("[create {}] Failed to execute \"{}\"", res, program);
+        throw std::runtime_error("Failed to execute");
+    }
+
+    record_spawn_time(t_start);
+
+    // blocking reads return as soon as output is available and fail when the child closes the pipe
+    std::string output;
+    FILE* p_stdout = subprocess_stdout(&process);
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), p_stdout)) > 0) {
+        output.append(buf, n);
+    }
+
+    int process_ret = -1;
+    res             = subprocess_join(&process, &process_ret);
+    subprocess_destroy(&process);
+
+    if (res != 0) {
+        Log.error("[join {}] Failed to execute \"{}\"", res, program);
+        throw std::runtime_error("Failed to execute");
+    }
+
+    return {process_ret, output};
+}
+#endif
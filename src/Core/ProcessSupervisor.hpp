@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Runs child processes and collects their combined stdout/stderr output
+/// The calling thread sleeps until the child writes output or exits (no polling intervals)
+/// Children run in their own process group so a failed build can stop compiler drivers together with their subprocesses
+class ProcessSupervisor {
+public:
+    struct SpawnStatistics {
+        uint64_t count;          // number of started processes
+        uint64_t total_spawn_ns; // time spent in starting processes (not including run time)
+    };
+
+public:
+    /// Run program with args and wait for it to exit
+    /// program can be a name from PATH or a path - PATH lookups are cached
+    /// Returns {exit code, combined stdout/stderr output}
+    static std::pair<int, std::string> run(const std::string& program, const std::vector<std::string>& args);
+
+    /// Find absolute path of program in PATH (result is cached for the whole run)
+    /// Returns program unchanged if it already is a path or if it is not found
+    static std::string resolve_program(const std::string& program);
+
+    static SpawnStatistics get_spawn_statistics();
+
+    /// Terminate all running child processes and every process started after this call
+    /// Only supported on Linux - on Windows running processes finish normally
+    static void terminate_all();
+
+    /// terminate_all() has been called
+    static bool is_terminating();
+
+    /// Run processes normally again after terminate_all() - called when a new build starts
+    static void reset();
+
+    /// Largest peak RSS (KiB) of processes run by the calling thread since reset_thread_peak_memory()
+    /// Always 0 on Windows
+    static uint64_t get_thread_peak_memory_kb();
+    static void reset_thread_peak_memory();
+};
@@ -1,12 +1,23 @@
 #include "Project.hpp"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <LuaBridge/LuaBridge.h>
 #include "Core/Archiver.hpp"
+#include "Core/BuildGraph.hpp"
+#include "Core/BuildPlan.hpp"
 #include "Core/Component.hpp"
+#include "Core/ContentHashCache.hpp"
+#include "Core/FileStatCache.hpp"
+#include "Core/FileWatcher.hpp"
 #include "Core/GIT.hpp"
+#include "Core/GitImportResolver.hpp"
 #include "Core/GlobalConfig.hpp"
+#include "Core/ImportLock.hpp"
+#include "Core/JobHistory.hpp"
+#include "Core/JobPool.hpp"
+#include "Core/ProcessSupervisor.hpp"
 #include "lauxlib.h"
 #include <lua.hpp>
 #include "LuaBackend.hpp"
@@ -15,16 +26,25 @@
 #include <regex>
 #include <CommandUtils.hpp>
 #include <FilesystemUtils.hpp>
+#include <HashUtils.hpp>
 #include <stdexcept>
 #include <vector>
 
 // folder inside of build path to write build files to
 #define BUILD_TEMP_LOCATION    "components"
 #define EXTERNAL_TEMP_LOCATION "external"
+#define JOB_HISTORY_FILE       "job_history.bin"
+#define IMPORT_LOCK_FILE       "cfxs.lock"
+#define CONTENT_HASH_FILE      "content_hashes.bin"
+#define BUILD_PLAN_FILE        "plan.bin"
+
+// --watch builds after no file changed for this time - editors and checkouts write multiple files
+static constexpr auto WATCH_SETTLE_TIME = std::chrono::milliseconds(100);
 
 extern std::vector<std::string> e_script_definitions;
 
 std::string s_current_namespace = "";
+bool s_thin_archives             = false; // default of libraries created after set_thin_archives()
 
 lua_State* s_MainLuaState;
 std::vector<std::shared_ptr<Component>> s_components;
@@ -33,6 +53,9 @@ std::filesystem::path s_project_path;
 std::filesystem::path s_output_path;
 std::vector<std::filesystem::path> s_script_path_stack;
 std::vector<std::filesystem::path> s_source_location_stack;
+// all scripts of the last configure with their modified times - changes need a new configure
+std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> s_loaded_scripts;
+bool s_scripts_executed = false; // last configure executed all scripts
 
 // Project state
 std::shared_ptr<Compiler> s_c_compiler;
@@ -40,6 +63,14 @@ std::shared_ptr<Compiler> s_cpp_compiler;
 std::shared_ptr<Compiler> s_asm_compiler;
 std::shared_ptr<Linker> s_linker;
 std::shared_ptr<Archiver> s_archiver;
+// size and modified time of the toolchain executables when the components were created (resident project)
+std::vector<BuildPlan::Input> s_toolchain_programs;
+
+// only exists while scripts are executed
+std::unique_ptr<GitImportResolver> s_git_import_resolver;
+
+// only exists with --content-hash
+std::unique_ptr<ContentHashCache> e_content_hash_cache;
 
 std::unordered_map<std::string, std::vector<std::string>> e_global_c_compile_options;
 std::unordered_map<std::string, std::vector<std::string>> e_global_cpp_compile_options;
@@ -62,7 +93,25 @@ void Project::uninitialize() {
     s_cpp_compiler.reset();
     s_asm_compiler.reset();
     s_linker.reset();
+    s_archiver.reset();
+    s_toolchain_programs.clear();
+    s_git_import_resolver.reset();
+    e_content_hash_cache.reset();
     s_components.clear();
+
+    // scripts are executed again in a new Lua state
+    e_global_c_compile_options.clear();
+    e_global_cpp_compile_options.clear();
+    e_global_definitions.clear();
+    e_global_include_paths.clear();
+    e_global_asm_compile_options.clear();
+    e_global_link_options.clear();
+    s_current_namespace = "";
+    s_thin_archives     = false;
+    if (s_MainLuaState) {
+        lua_close(s_MainLuaState);
+        s_MainLuaState = nullptr;
+    }
 }
 
 void Project::initialize(const std::filesystem::path& project_path, const std::filesystem::path& output_path) {
@@ -80,9 +129,17 @@ void Project::initialize(const std::filesystem::path& project_path, const std::f
         }
     }
 
+    if (GlobalConfig::content_hash()) {
+        e_content_hash_cache = std::make_unique<ContentHashCache>(s_output_path / CONTENT_HASH_FILE);
+        e_content_hash_cache->load();
+    }
+
     initialize_lua();
 }
 
+/// Project is kept in memory to build again (--watch, --daemon) - script errors do not exit
+static bool is_resident() { return GlobalConfig::watch() || GlobalConfig::daemon(); }
+
 static void print_traceback(const std::filesystem::path& source_location) {
     std::string error = lua_tostring(s_MainLuaState, -1);
 
@@ -107,33 +164,313 @@ static void print_traceback(const std::filesystem::path& source_location) {
     }
 }
 
-void Project::configure() {
-    Log.info("Configure Project");
-    const auto t1 = std::chrono::high_resolution_clock::now();
-
+/// Execute .cfxs-build scripts - creates all components
+static void execute_root_script() {
     const auto source_location = s_project_path / ".cfxs-build";
     const auto root_buildfile  = read_source(source_location);
 
     // root script path
     s_script_path_stack     = {s_project_path};
     s_source_location_stack = {source_location};
+    s_loaded_scripts        = {{source_location, FileStatCache::stat(source_location.string()).modified_time}};
+    s_scripts_executed      = false;
+
+    ImportLock import_lock(s_project_path / IMPORT_LOCK_FILE);
+    import_lock.load();
+
+    // shared mirrors are only needed when git runs
+    std::unique_ptr<GitMirrorCache> mirror_cache;
+    const auto mirror_directory = GitMirrorCache::get_default_directory();
+    if (GlobalConfig::git_cache_size_mb() > 0 && !GlobalConfig::offline_imports() && !mirror_directory.empty()) {
+        mirror_cache = std::make_unique<GitMirrorCache>(mirror_directory, (uint64_t)GlobalConfig::git_cache_size_mb() * 1024 * 1024);
+    }
+
+    s_git_import_resolver = std::make_unique<GitImportResolver>(s_output_path / EXTERNAL_TEMP_LOCATION, import_lock, mirror_cache.get());
+    s_git_import_resolver->prefetch(source_location);
 
     try {
         // execute root_buildfile into lua state
         if (luaL_dofile(s_MainLuaState, source_location.string().c_str())) {
             // get and log lua error callstack
             print_traceback(source_location);
-            exit(-1);
-            throw std::runtime_error("Failed to execute script");
-        } else {
-            for (auto& comp : s_components) {
-                comp->configure(s_c_compiler, s_cpp_compiler, s_asm_compiler, s_linker, s_archiver);
-            }
+            if (!is_resident())
+                exit(-1);
+            throw std::runtime_error("Failed to execute script"); // resident project waits for the script to be fixed
+        }
+    } catch (...) {
+        s_git_import_resolver.reset(); // uses import_lock and mirror_cache
+        throw;
+    }
+
+    s_git_import_resolver.reset();
+    s_scripts_executed = true;
+
+    if (mirror_cache)
+        mirror_cache->evict();
+
+    // lock file records the checkouts used by this configure, offline checkouts are not changed
+    if (!GlobalConfig::offline_imports())
+        import_lock.save();
+}
+
+////////////////////////////////////
+// Build plan
+
+static void write_compiler(BuildPlan::Writer& writer, const Compiler* compiler) {
+    writer.write((uint8_t)(compiler != nullptr));
+    if (!compiler)
+        return;
+    writer.write(compiler->get_location());
+    writer.write(compiler->get_executable_path());
+    writer.write(compiler->get_version_string());
+    writer.write(compiler->get_standard_number());
+}
+
+/// Tools are created with the stored version - return false if the executable resolves to a different path now
+static bool read_compiler(BuildPlan::Reader& reader, Compiler::Language language, std::shared_ptr<Compiler>& compiler) {
+    uint8_t present = 0;
+    reader.read(present);
+    if (!present)
+        return !reader.failed();
+
+    std::string location, executable_path, version, standard;
+    reader.read(location);
+    reader.read(executable_path);
+    reader.read(version);
+    reader.read(standard);
+    if (reader.failed())
+        return false;
+
+    compiler = std::make_shared<Compiler>(language, location, standard, true, version);
+    return compiler->get_executable_path() == executable_path;
+}
+
+template<typename T>
+static void write_tool(BuildPlan::Writer& writer, const T* tool) {
+    writer.write((uint8_t)(tool != nullptr));
+    if (!tool)
+        return;
+    writer.write(tool->get_location());
+    writer.write(tool->get_executable_path());
+    writer.write(tool->get_version_string());
+}
+
+template<typename T>
+static bool read_tool(BuildPlan::Reader& reader, std::shared_ptr<T>& tool) {
+    uint8_t present = 0;
+    reader.read(present);
+    if (!present)
+        return !reader.failed();
+
+    std::string location, executable_path, version;
+    reader.read(location);
+    reader.read(executable_path);
+    reader.read(version);
+    if (reader.failed())
+        return false;
+
+    tool = std::make_shared<T>(location, true, version);
+    return tool->get_executable_path() == executable_path;
+}
+
+template<typename T>
+static void write_global_options(BuildPlan::Writer& writer, const std::unordered_map<std::string, std::vector<T>>& options) {
+    writer.write((uint32_t)options.size());
+    for (const auto& [ns, values] : options) {
+        writer.write(ns);
+        writer.write(values);
+    }
+}
+
+template<typename T>
+static void read_global_options(BuildPlan::Reader& reader, std::unordered_map<std::string, std::vector<T>>& options) {
+    uint32_t count = 0;
+    reader.read(count);
+    for (uint32_t i = 0; i < count && !reader.failed(); i++) {
+        std::string ns;
+        reader.read(ns);
+        reader.read(options[ns]);
+    }
+}
+
+/// Size and modified time of toolchain executables
+static std::vector<BuildPlan::Input> read_toolchain_programs() {
+    std::vector<BuildPlan::Input> programs;
+    const auto add_program = [&](const auto& tool) {
+        if (tool)
+            programs.push_back({BuildPlan::InputType::PROGRAM,
+                                tool->get_executable_path(),
+                                BuildPlan::read_input(BuildPlan::InputType::PROGRAM, tool->get_executable_path())});
+    };
+    add_program(s_c_compiler);
+    add_program(s_cpp_compiler);
+    add_program(s_asm_compiler);
+    add_program(s_linker);
+    add_program(s_archiver);
+    return programs;
+}
+
+/// Save toolchain, global options and components created by the scripts with everything the scripts read
+static void save_build_plan() {
+    const auto path = s_output_path / BUILD_PLAN_FILE;
+    if (BuildPlan::have_volatile_input()) {
+        Log.trace("Build plan not saved - scripts read the current time or used the debug library");
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return;
+    }
+
+    auto inputs = BuildPlan::get_recorded_inputs();
+    for (const auto& [script, modified_time] : s_loaded_scripts) {
+        const auto key = script.string();
+        inputs.push_back({BuildPlan::InputType::SCRIPT, key, BuildPlan::read_input(BuildPlan::InputType::SCRIPT, key)});
+    }
+
+    // checkouts of git imports follow the lock file
+    const auto lock_path = (s_project_path / IMPORT_LOCK_FILE).string();
+    inputs.push_back({BuildPlan::InputType::FILE, lock_path, BuildPlan::read_input(BuildPlan::InputType::FILE, lock_path)});
+
+    const auto programs = read_toolchain_programs();
+    inputs.insert(inputs.end(), programs.begin(), programs.end());
+
+    BuildPlan::Writer writer;
+    write_compiler(writer, s_c_compiler.get());
+    write_compiler(writer, s_cpp_compiler.get());
+    write_compiler(writer, s_asm_compiler.get());
+    write_tool(writer, s_linker.get());
+    write_tool(writer, s_archiver.get());
+
+    write_global_options(writer, e_global_c_compile_options);
+    write_global_options(writer, e_global_cpp_compile_options);
+    write_global_options(writer, e_global_definitions);
+    write_global_options(writer, e_global_include_paths);
+    write_global_options(writer, e_global_asm_compile_options);
+    write_global_options(writer, e_global_link_options);
+
+    writer.write((uint32_t)s_components.size());
+    for (const auto& comp : s_components) {
+        comp->write_plan(writer);
+    }
+    for (const auto& comp : s_components) {
+        std::vector<std::string> libraries;
+        for (const auto* lib : comp->get_libraries()) {
+            libraries.push_back(lib->get_name());
+        }
+        writer.write(libraries);
+    }
+
+    BuildPlan::save(path, s_project_path, e_script_definitions, inputs, writer.get_data());
+}
+
+/// Create toolchain, global options and components from the saved build plan
+/// Return false if the scripts have to be executed
+static bool load_build_plan() {
+    std::vector<BuildPlan::Input> inputs;
+    std::string content;
+    if (!BuildPlan::load(s_output_path / BUILD_PLAN_FILE, s_project_path, e_script_definitions, inputs, content))
+        return false;
+
+    // executing the scripts updates git imports
+    const bool update_imports = !GlobalConfig::offline_imports() && !GlobalConfig::skip_git_import_update();
+    if (update_imports && std::any_of(inputs.begin(), inputs.end(), [](const auto& input) {
+            return input.type == BuildPlan::InputType::GIT_HEAD;
+        })) {
+        Log.trace("Build plan not used - git imports are updated");
+        return false;
+    }
+
+    std::shared_ptr<Compiler> c_compiler, cpp_compiler, asm_compiler;
+    std::shared_ptr<Linker> linker;
+    std::shared_ptr<Archiver> archiver;
+    decltype(e_global_c_compile_options) c_compile_options, cpp_compile_options, definitions, asm_compile_options, link_options;
+    decltype(e_global_include_paths) include_paths;
+    std::vector<std::shared_ptr<Component>> components;
+
+    BuildPlan::Reader reader(content);
+    try {
+        if (!read_compiler(reader, Compiler::Language::C, c_compiler) || !read_compiler(reader, Compiler::Language::CPP, cpp_compiler) ||
+            !read_compiler(reader, Compiler::Language::ASM, asm_compiler) || !read_tool(reader, linker) || !read_tool(reader, archiver)) {
+            Log.trace("Build plan not used - toolchain changed");
+            return false;
         }
     } catch (const std::runtime_error& e) {
-        throw e;
+        Log.trace("Build plan not used - {}", e.what());
+        return false;
     }
 
+    read_global_options(reader, c_compile_options);
+    read_global_options(reader, cpp_compile_options);
+    read_global_options(reader, definitions);
+    read_global_options(reader, include_paths);
+    read_global_options(reader, asm_compile_options);
+    read_global_options(reader, link_options);
+
+    uint32_t component_count = 0;
+    reader.read(component_count);
+    for (uint32_t i = 0; i < component_count && !reader.failed(); i++) {
+        auto comp = Component::read_plan(reader);
+        if (comp)
+            components.push_back(comp);
+    }
+    for (auto& comp : components) {
+        std::vector<std::string> libraries;
+        reader.read(libraries);
+        for (const auto& name : libraries) {
+            const auto it = std::find_if(components.begin(), components.end(), [&](const auto& lib) {
+                return lib->get_name() == name;
+            });
+            if (it == components.end()) {
+                Log.trace("Build plan not used - library \"{}\" not found", name);
+                return false;
+            }
+            comp->add_library(it->get());
+        }
+    }
+    if (reader.failed() || components.size() != component_count) {
+        Log.trace("Ignoring invalid build plan content");
+        return false;
+    }
+
+    s_c_compiler                 = c_compiler;
+    s_cpp_compiler               = cpp_compiler;
+    s_asm_compiler               = asm_compiler;
+    s_linker                     = linker;
+    s_archiver                   = archiver;
+    e_global_c_compile_options   = std::move(c_compile_options);
+    e_global_cpp_compile_options = std::move(cpp_compile_options);
+    e_global_definitions         = std::move(definitions);
+    e_global_include_paths       = std::move(include_paths);
+    e_global_asm_compile_options = std::move(asm_compile_options);
+    e_global_link_options        = std::move(link_options);
+    s_components                 = std::move(components);
+
+    s_loaded_scripts.clear();
+    for (const auto& input : inputs) {
+        if (input.type == BuildPlan::InputType::SCRIPT)
+            s_loaded_scripts.emplace_back(input.key, FileStatCache::stat(input.key).modified_time);
+    }
+    s_scripts_executed = true;
+
+    Log.info("Build scripts unchanged - using saved build plan");
+    return true;
+}
+
+/// Create components from the saved build plan or by executing the scripts
+static void create_components() {
+    if (!GlobalConfig::use_build_plan() || !load_build_plan()) {
+        BuildPlan::begin_recording();
+        execute_root_script();
+        if (GlobalConfig::use_build_plan())
+            save_build_plan();
+    }
+
+    s_toolchain_programs = read_toolchain_programs();
+}
+
+////////////////////////////////////
+
+/// Create single compile_commands for all components in s_project_path
+static void write_compile_commands() {
     auto c_paths   = s_c_compiler->get_stdlib_paths();
     auto cpp_paths = s_cpp_compiler->get_stdlib_paths();
 
@@ -142,7 +479,6 @@ void Project::configure() {
     for (auto& p : cpp_paths)
         p = replace_string(p, "\\", "\\\\");
 
-    // create single compile_commands for all components in s_project_path
     if (GlobalConfig::generate_compile_commands()) {
         std::string compile_commands;
         for (const auto& comp : s_components) {
@@ -185,6 +521,20 @@ void Project::configure() {
         }
     }
 
+}
+
+void Project::configure() {
+    Log.info("Configure Project");
+    const auto t1 = std::chrono::high_resolution_clock::now();
+
+    create_components();
+    for (auto& comp : s_components) {
+        comp->configure(s_c_compiler, s_cpp_compiler, s_asm_compiler, s_linker, s_archiver);
+    }
+    write_compile_commands();
+    if (e_content_hash_cache)
+        e_content_hash_cache->save();
+
     const auto t2 = std::chrono::high_resolution_clock::now();
     auto ms       = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
     Log.info("Project configure done in {:.3f}s", ms / 1000.0f);
@@ -192,14 +542,10 @@ void Project::configure() {
 
 int e_total_project_source_count           = 0;
 int e_current_abs_source_index             = 1;
+extern std::mutex s_source_index_mutex;
 
-extern uint32_t s_fmc_hits;
-extern uint32_t s_fmc_misses;
-
-void Project::build(const std::vector<std::string>& components) {
-    Log.info("Build Project");
-    const auto t1 = std::chrono::high_resolution_clock::now();
 
+static std::vector<std::shared_ptr<Component>> get_components_to_build(const std::vector<std::string>& components) {
     std::vector<std::shared_ptr<Component>> components_to_build;
 
     if (std::find(components.begin(), components.end(), "*") != components.end()) {
@@ -227,19 +573,436 @@ void Project::build(const std::vector<std::string>& components) {
         }
     }
 
+    return components_to_build;
+}
+
+/// Single job graph of all components that are built
+/// compile entries -> component archive/link <- library archive
+/// Job durations and memory usage are recorded for the next build
+class ProjectBuildGraph {
+public:
+    ProjectBuildGraph() :
+        m_job_history(s_output_path / JOB_HISTORY_FILE),
+        m_graph(GlobalConfig::keep_going(), ProcessSupervisor::terminate_all) {
+        // failure of a previous build (--watch, daemon) must not terminate the jobs of this one
+        ProcessSupervisor::reset();
+        m_job_history.load();
+
+        // unknown jobs are assumed to be like an average known job
+        m_default_cost      = std::max<uint64_t>(m_job_history.get_average_duration(), 1);
+        m_default_memory_kb = m_job_history.get_average_peak_memory_kb();
+    }
+
+    BuildGraph& get_graph() { return m_graph; }
+
+    /// Add archive/link job of component
+    /// held - job will not start before release_finalize_node() (compile entries are still being created)
+    void add_finalize_node(Component* comp, bool held) {
+        if (m_finalize_nodes.contains(comp))
+            return;
+
+        const auto key = HashUtils::fnv1a_field("finalize", HashUtils::fnv1a_field(comp->get_name()));
+        auto* node     = m_graph.add_node(
+            comp->get_name(),
+            [this, comp, key]() {
+                return timed_job(key, [comp]() {
+                    comp->finalize();
+                    return true;
+                });
+            },
+            held);
+        set_cost(node, key);
+        m_finalize_nodes[comp] = node;
+        m_components.push_back(comp);
+    }
+
+    void release_finalize_node(Component* comp) {
+        const auto it = m_finalize_nodes.find(comp);
+        if (it != m_finalize_nodes.end())
+            m_graph.release(it->second);
+    }
+
+    bool contains(const Component* comp) const { return m_finalize_nodes.contains(comp); }
+
+    /// Add compile job of entry (safe to call from multiple threads while graph is executing)
+    /// precompiled header is always the first entry and has to be done before other sources of the component
+    void add_compile_node(Component* comp, CompileEntry* entry) {
+        auto* node = m_graph.add_node(
+            entry->source_entry->get_source_file_path().string(),
+            [this, comp, entry]() {
+                return timed_job(entry->command_hash, [comp, entry]() {
+                    return comp->compile(*entry);
+                });
+            },
+            true);
+        set_cost(node, entry->command_hash);
+
+        if (entry->source_entry->is_pch()) {
+            std::lock_guard<std::mutex> lock(m_mutex_pch_nodes);
+            m_pch_nodes[comp] = node;
+        } else {
+            BuildGraph::Node* pch_node = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex_pch_nodes);
+                const auto it = m_pch_nodes.find(comp);
+                if (it != m_pch_nodes.end())
+                    pch_node = it->second;
+            }
+            if (pch_node)
+                m_graph.add_dependency(node, pch_node);
+        }
+
+        m_graph.add_dependency(m_finalize_nodes.at(comp), node);
+        m_graph.release(node);
+    }
+
+    /// archive/link after all used libraries are archived
+    void add_library_dependencies() {
+        for (const auto& [comp, finalize_node] : m_finalize_nodes) {
+            for (const auto* lib : comp->get_libraries()) {
+                const auto it = m_finalize_nodes.find(lib);
+                if (it != m_finalize_nodes.end())
+                    m_graph.add_dependency(finalize_node, it->second);
+            }
+        }
+    }
+
+    /// Save job history and compile state of all components for the next build
+    void save_state() {
+        m_job_history.save();
+        if (e_content_hash_cache)
+            e_content_hash_cache->save();
+        for (auto* comp : m_components) {
+            comp->save_build_database();
+        }
+    }
+
+    /// List all failed jobs after the build (errors of keep-going builds are spread over the whole log)
+    void report_failures() const {
+        const auto& failed = m_graph.get_failed_node_names();
+        if (failed.empty())
+            return;
+
+        Log.error("{} failed job{}:", failed.size(), failed.size() == 1 ? "" : "s");
+        for (const auto& name : failed) {
+            Log.error(" - {}", name);
+        }
+        if (m_graph.get_skipped_node_count())
+            Log.error("{} job{} skipped because of failed dependencies",
+                      m_graph.get_skipped_node_count(),
+                      m_graph.get_skipped_node_count() == 1 ? "" : "s");
+    }
+
+private:
+    /// Run job and record its duration and peak memory usage for the next build
+    bool timed_job(uint64_t key, const std::function<bool()>& job) {
+        ProcessSupervisor::reset_thread_peak_memory();
+        const auto start   = std::chrono::steady_clock::now();
+        const bool success = job();
+        if (success) {
+            const auto duration = std::chrono::steady_clock::now() - start;
+            m_job_history.record(key,
+                                 (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(),
+                                 (uint32_t)ProcessSupervisor::get_thread_peak_memory_kb());
+        }
+        return success;
+    }
+
+    void set_cost(BuildGraph::Node* node, uint64_t key) {
+        const auto duration    = m_job_history.get_duration(key);
+        const auto peak_memory = m_job_history.get_peak_memory_kb(key);
+        node->cost             = duration ? duration : m_default_cost;
+        node->memory_kb        = peak_memory ? peak_memory : m_default_memory_kb;
+    }
+
+private:
+    JobHistory m_job_history;
+    uint64_t m_default_cost;
+    uint64_t m_default_memory_kb;
+
+    BuildGraph m_graph;
+    std::vector<Component*> m_components;
+    std::unordered_map<const Component*, BuildGraph::Node*> m_finalize_nodes;
+    std::unordered_map<const Component*, BuildGraph::Node*> m_pch_nodes;
+    std::mutex m_mutex_pch_nodes;
+};
+
+static JobPool create_job_pool() {
+    return JobPool(GlobalConfig::number_of_worker_threads(), GlobalConfig::max_load_average(), GlobalConfig::adaptive_jobs());
+}
+
+/// Log build results and throw if build failed
+static void finish_build(bool success, const JobPool& job_pool, std::chrono::high_resolution_clock::time_point t1) {
+    if (job_pool.get_load_throttle_count())
+        Log.info("Job start delayed by load average {} times", job_pool.get_load_throttle_count());
+    if (job_pool.get_memory_throttle_count())
+        Log.info("Job start delayed by memory pressure {} times (lowest job limit {})",
+                 job_pool.get_memory_throttle_count(),
+                 job_pool.get_lowest_adaptive_limit());
+
+    if (!success) {
+        throw std::runtime_error("Compilation failed");
+    }
+
+    const auto t2 = std::chrono::high_resolution_clock::now();
+    auto ms       = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+    Log.info("Project build done in {:.3f}s ({}m {}s) ", ms / 1000.0f, (ms / 1000) / 60, (ms / 1000) % 60);
+    Log.info("File Modified Cache [{}/{}]", FileStatCache::get_hit_count(), FileStatCache::get_miss_count());
+
+    const auto spawn_stats = ProcessSupervisor::get_spawn_statistics();
+    if (spawn_stats.count)
+        Log.trace("Process spawn: {} processes, {:.1f}us average", spawn_stats.count, spawn_stats.total_spawn_ns / 1000.0 / spawn_stats.count);
+}
+
+void Project::build(const std::vector<std::string>& components) {
+    Log.info("Build Project");
+    const auto t1 = std::chrono::high_resolution_clock::now();
+
+    const auto components_to_build = get_components_to_build(components);
+
     e_total_project_source_count = 0;
     e_current_abs_source_index   = 1;
     for (auto& c : components_to_build) {
         e_total_project_source_count += c->get_compile_entries().size();
     }
+
+    ProjectBuildGraph build_graph;
     for (auto& c : components_to_build) {
-        c->build();
+        build_graph.add_finalize_node(c.get(), false);
+        for (const auto& ce : c->get_compile_entries()) {
+            build_graph.add_compile_node(c.get(), ce.get());
+        }
     }
+    build_graph.add_library_dependencies();
 
-    const auto t2 = std::chrono::high_resolution_clock::now();
-    auto ms       = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
-    Log.info("Project build done in {:.3f}s ({}m {}s) ", ms / 1000.0f, (ms / 1000) / 60, (ms / 1000) % 60);
-    Log.info("File Modified Cache [{}/{}]", s_fmc_hits, s_fmc_misses);
+    Log.trace("Build graph: {} jobs", build_graph.get_graph().get_node_count());
+
+    auto job_pool = create_job_pool();
+    bool success  = false;
+    try {
+        success = build_graph.get_graph().execute(job_pool);
+    } catch (...) {
+        build_graph.save_state();
+        build_graph.report_failures();
+        throw;
+    }
+    build_graph.save_state();
+    build_graph.report_failures();
+
+    finish_build(success, job_pool, t1);
+}
+
+/// Configure components created by the scripts and build them in one pass
+static void configure_components_and_build(const std::vector<std::string>& components,
+                                           std::chrono::high_resolution_clock::time_point t1) {
+    const auto components_to_build = get_components_to_build(components);
+
+    e_total_project_source_count = 0;
+    e_current_abs_source_index   = 1;
+
+    // archive/link jobs are held until their component is configured
+    ProjectBuildGraph build_graph;
+    for (auto& c : components_to_build) {
+        build_graph.add_finalize_node(c.get(), true);
+    }
+    build_graph.add_library_dependencies();
+
+    auto job_pool = create_job_pool();
+    auto& graph   = build_graph.get_graph();
+    graph.start(job_pool);
+
+    bool success = false;
+    try {
+        // compile entries start compiling as soon as they are created
+        for (auto& comp : s_components) {
+            auto* c = comp.get();
+            if (!build_graph.contains(c)) {
+                comp->configure(s_c_compiler, s_cpp_compiler, s_asm_compiler, s_linker, s_archiver);
+                continue;
+            }
+
+            comp->configure(s_c_compiler, s_cpp_compiler, s_asm_compiler, s_linker, s_archiver, [&build_graph, c](CompileEntry* entry) {
+                s_source_index_mutex.lock();
+                e_total_project_source_count++;
+                s_source_index_mutex.unlock();
+                build_graph.add_compile_node(c, entry);
+            });
+            build_graph.release_finalize_node(c);
+        }
+
+        const auto t2 = std::chrono::high_resolution_clock::now();
+        auto ms       = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+        Log.info("Project configure done in {:.3f}s", ms / 1000.0f);
+
+        write_compile_commands();
+
+        Log.trace("Build graph: {} jobs", graph.get_node_count());
+        success = graph.wait();
+    } catch (...) {
+        graph.cancel();
+        build_graph.save_state();
+        build_graph.report_failures();
+        throw;
+    }
+    build_graph.save_state();
+    build_graph.report_failures();
+
+    finish_build(success, job_pool, t1);
+}
+
+void Project::configure_and_build(const std::vector<std::string>& components) {
+    Log.info("Configure and Build Project");
+    const auto t1 = std::chrono::high_resolution_clock::now();
+
+    create_components();
+    configure_components_and_build(components, t1);
+}
+
+/// Sources of wildcards - adding or removing them changes the source lists of components
+static bool is_source_file(const std::filesystem::path& path) {
+    auto ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) {
+        return std::tolower(c);
+    });
+    return ext == ".c" || ext == ".cpp" || ext == ".cc" || ext == ".cxx" || ext == ".c++" || ext == ".asm" || ext == ".s";
+}
+
+/// Watch scripts and inputs of all components
+static void add_watched_files(FileWatcher& watcher) {
+    // files in the output directory are written by the build itself (generated precompiled headers, git imports)
+    const auto output_path = (s_output_path / "").string();
+    const auto add         = [&](const std::filesystem::path& path) {
+        if (!std::filesystem::absolute(path).lexically_normal().string().starts_with(output_path))
+            watcher.add(path);
+    };
+
+    for (const auto& [script, modified_time] : s_loaded_scripts) {
+        add(script);
+    }
+    for (const auto& comp : s_components) {
+        for (const auto& path : comp->get_input_paths()) {
+            add(path);
+        }
+    }
+}
+
+static bool is_loaded_script(const std::filesystem::path& path) {
+    return std::find_if(s_loaded_scripts.begin(), s_loaded_scripts.end(), [&](const auto& script) {
+               return script.first == path;
+           }) != s_loaded_scripts.end();
+}
+
+static bool have_loaded_scripts_changed() {
+    for (const auto& [script, modified_time] : s_loaded_scripts) {
+        if (FileStatCache::stat(script.string()).modified_time != modified_time)
+            return true;
+    }
+    return false;
+}
+
+/// Toolchain executables were replaced (toolchain update) since the components were created
+static bool have_toolchain_programs_changed() {
+    return std::any_of(s_toolchain_programs.begin(), s_toolchain_programs.end(), [](const auto& program) {
+        return BuildPlan::read_input(program.type, program.key) != program.value;
+    });
+}
+
+/// Prepare configure of the project kept in memory after files changed
+/// Changed scripts are executed again in a new Lua state - otherwise the existing components are configured again
+/// Tools are created again by executing the scripts if a toolchain executable changed
+static void prepare_configure_again(bool scripts_changed, bool sources_changed) {
+    // modified times, content hashes and git state of the last build are outdated
+    FileStatCache::invalidate();
+    if (e_content_hash_cache)
+        e_content_hash_cache->invalidate();
+    GIT::invalidate_cache();
+
+    if (!scripts_changed && have_toolchain_programs_changed()) {
+        Log.info("Toolchain changed");
+        scripts_changed = true;
+    }
+
+    if (scripts_changed) {
+        Log.info("Build script changed");
+        const auto project_path = s_project_path;
+        const auto output_path  = s_output_path;
+        Project::uninitialize();
+        Project::initialize(project_path, output_path);
+        create_components();
+    } else if (sources_changed) {
+        for (auto& comp : s_components) {
+            comp->invalidate_source_file_paths();
+        }
+    }
+}
+
+void Project::watch(const std::vector<std::string>& components) {
+    FileWatcher watcher;
+
+    while (true) {
+        add_watched_files(watcher);
+        Log.info("Watching {} files in {} directories for changes", watcher.get_file_count(), watcher.get_directory_count());
+
+        const auto changes = watcher.wait(WATCH_SETTLE_TIME);
+
+        bool scripts_changed = !s_scripts_executed; // configure again after any change until scripts work again
+        bool sources_changed = false;
+        for (const auto& path : changes.modified) {
+            Log.debug("Changed: {}", path);
+            if (is_loaded_script(path))
+                scripts_changed = true;
+            if (is_source_file(path) && !std::filesystem::exists(path))
+                sources_changed = true; // source was removed
+        }
+        for (const auto& path : changes.directory_entries) {
+            if (is_source_file(path)) {
+                Log.debug("Added/removed: {}", path);
+                sources_changed = true;
+            }
+        }
+
+        if (changes.modified.empty() && !sources_changed)
+            continue; // unrelated files of watched directories
+
+        try {
+            Log.info("Build changes");
+            const auto t1 = std::chrono::high_resolution_clock::now();
+            prepare_configure_again(scripts_changed, sources_changed);
+
+            // no object depends on the linker script
+            for (auto& comp : s_components) {
+                if (comp->get_linker_script_path().empty())
+                    continue;
+                const auto path = std::filesystem::weakly_canonical(comp->get_root_path() / comp->get_linker_script_path());
+                if (std::find(changes.modified.begin(), changes.modified.end(), path) != changes.modified.end())
+                    comp->force_finalize();
+            }
+
+            configure_components_and_build(components, t1);
+        } catch (const std::runtime_error& e) {
+            Log.error("Failed to build project: {}", e.what());
+        }
+    }
+}
+
+void Project::build_resident(const std::vector<std::string>& clean_components, const std::vector<std::string>& components) {
+    Log.info("Build Project");
+    const auto t1 = std::chrono::high_resolution_clock::now();
+
+    // changes since the last build are not known - scripts are checked and sources are searched again
+    prepare_configure_again(!s_scripts_executed || have_loaded_scripts_changed(), true);
+
+    if (!clean_components.empty())
+        clean(clean_components);
+    if (!components.empty())
+        configure_components_and_build(components, t1);
+}
+
+void Project::log_components() {
+    for (const auto& comp : s_components) {
+        const auto type = comp->get_type() == Component::Type::LIBRARY ? "library" : "executable";
+        Log.info("{} ({}) {}", comp->get_name(), type, comp->get_script_path());
+    }
 }
 
 void Project::clean(const std::vector<std::string>& components) {
@@ -327,6 +1090,36 @@ void Project::initialize_lua() {
         lua_pop(L, 1);
     }
 
+    // environment variables are inputs of the build plan - the current time can not be reused by a build plan
+    // scripts have no other way to read files or run programs: removed libraries are also removed from the registry
+    // and the debug library (access to the registry and to the original functions) makes the plan volatile
+    luaL_loadstring(L, R"(
+        local getenv = os.getenv
+        os.getenv = function(name)
+            local value = getenv(name)
+            __cfxs_record_env(name, value ~= nil, value or "")
+            return value
+        end
+        for _, name in ipairs({"time", "clock", "date", "tmpname"}) do
+            local f = os[name]
+            os[name] = function(...)
+                __cfxs_record_volatile()
+                return f(...)
+            end
+        end
+        local loaded = debug.getregistry()._LOADED
+        for _, name in ipairs({"io", "package", "coroutine"}) do
+            loaded[name] = nil
+        end
+        for name, f in pairs(debug) do
+            debug[name] = function(...)
+                __cfxs_record_volatile()
+                return f(...)
+            end
+        end
+    )");
+    lua_pcall(L, 0, 0, 0);
+
     auto bridge = luabridge::getGlobalNamespace(L);
 
     bridge.addFunction<void, const std::string&, const std::string&>("set_c_compiler", TO_FUNCTION(lua_set_c_compiler));
@@ -336,6 +1129,7 @@ void Project::initialize_lua() {
     bridge.addFunction<void, const std::string&>("set_archiver", TO_FUNCTION(lua_set_archiver));
 
     bridge.addFunction<void, const std::string&>("set_namespace", TO_FUNCTION(lua_set_namespace));
+    bridge.addFunction<void, bool>("set_thin_archives", TO_FUNCTION(lua_set_thin_archives));
     bridge.addFunction<bool, const std::string&>("have_var", TO_FUNCTION(lua_have_var));
 
     bridge.addFunction<void, const std::string&, const std::string&, const std::string&>("set_c_compiler_known",
@@ -347,6 +1141,8 @@ void Project::initialize_lua() {
     bridge.addFunction<void, const std::string&, const std::string&>("set_archiver_known", TO_FUNCTION(lua_set_archiver_known));
 
     bridge.addFunction<void, const std::string&>("__cfxs_print", TO_FUNCTION(lua_cfxs_print));
+    bridge.addFunction<void, const std::string&, bool, const std::string&>("__cfxs_record_env", TO_FUNCTION(lua_cfxs_record_env));
+    bridge.addFunction<void>("__cfxs_record_volatile", TO_FUNCTION(lua_cfxs_record_volatile));
     bridge.addFunction<bool, const std::string&>("exists", TO_FUNCTION(lua_exists));
     bridge.addFunction<std::string, lua_State*>("get_current_directory_path", TO_FUNCTION(lua_get_current_directory_path));
     bridge.addFunction<std::string, lua_State*>("get_current_script_path", TO_FUNCTION(lua_get_current_script_path));
@@ -368,6 +1164,7 @@ void Project::initialize_lua() {
         .addFunction("add_definitions", /*****************/ &Component::lua_add_definitions)
         .addFunction("add_compile_options", /*************/ &Component::lua_add_compile_options)
         .addFunction("set_linker_script", /***************/ &Component::lua_set_linker_script)
+        .addFunction("set_thin_archive", /****************/ &Component::lua_set_thin_archive)
         .addFunction("add_libraries", /*******************/ &Component::lua_add_libraries)
         .addFunction("add_link_options", /****************/ &Component::lua_add_link_options)
         .addFunction("create_precompiled_header", /*******/ &Component::lua_create_precompiled_header)
@@ -399,15 +1196,25 @@ void Project::lua_cfxs_print(const std::string& str) {
 bool Project::lua_exists(const std::string& path_str) {
     const std::filesystem::path path = path_str;
     const auto p                     = path.is_relative() ? s_script_path_stack.back() / path : path;
-    return std::filesystem::exists(p);
+    const bool exists                = std::filesystem::exists(p);
+    BuildPlan::record_input(BuildPlan::InputType::EXISTS, p.string(), exists ? "1" : "0");
+    return exists;
 }
 
 std::string Project::lua_get_current_directory_path(lua_State*) { return s_script_path_stack.back().string(); }
 
 std::string Project::lua_get_current_script_path(lua_State*) { return s_source_location_stack.back().string(); }
 
+void Project::lua_cfxs_record_env(const std::string& name, bool is_set, const std::string& value) {
+    BuildPlan::record_input(BuildPlan::InputType::ENVIRONMENT, name, is_set ? "=" + value : "");
+}
+
+void Project::lua_cfxs_record_volatile() { BuildPlan::record_volatile_input(); }
+
 void Project::lua_set_namespace(const std::string& ns) { s_current_namespace = ns.empty() ? "" : (ns + "_"); }
 
+void Project::lua_set_thin_archives(bool enabled) { s_thin_archives = enabled; }
+
 bool Project::lua_have_var(const std::string& name) {
     const auto it = std::find_if(e_script_definitions.begin(), e_script_definitions.end(), [&](const auto& def) {
         return def.starts_with(name);
@@ -496,6 +1303,12 @@ void Project::lua_import(lua_State* L) {
         throw std::runtime_error("recursive import cycle");
     }
 
+    s_loaded_scripts.emplace_back(source_location, FileStatCache::stat(source_location.string()).modified_time);
+
+    // start fetching git imports of this script before it needs them
+    if (s_git_import_resolver)
+        s_git_import_resolver->prefetch(source_location);
+
     try {
         const bool failed = luaL_dofile_with_n_args(s_MainLuaState, source_location.string().c_str(), extra_arg_count, [&]() {
             if (extra_arg_count) {
@@ -512,8 +1325,14 @@ void Project::lua_import(lua_State* L) {
         if (failed) {
             // get and log lua error callstack
             print_traceback(source_location);
-            exit(-1);
-            throw std::runtime_error("Failed to execute script");
+            if (!is_resident())
+                exit(-1);
+
+            // fail importing script - resident project waits for the script to be fixed
+            s_script_path_stack.pop_back();
+            s_source_location_stack.pop_back();
+            luaL_error(s_MainLuaState, "Failed to import \"%s\"", source_location.string().c_str());
+            return;
         }
     } catch (const std::runtime_error& e) {
         Log.error("Import load failed: {}", e.what());
@@ -545,71 +1364,22 @@ void Project::lua_import_git(lua_State* L) {
         throw std::runtime_error("Invalid import git argument");
     }
 
-    auto url = arg_url.tostring();
-    // trim spaces from start and end
-    url = url.substr(url.find_first_not_of(" \t"));
-    url = url.substr(0, url.find_last_not_of(" \t") + 1);
-
+    auto url          = arg_url.tostring();
     const auto branch = arg_branch.isNil() ? "" : arg_branch.tostring();
 
-    if (url.length() < 4 || url.substr(url.length() - 4) != ".git") {
-        url += ".git";
-    }
-
-    std::regex git_url_regex(R"(http[s]?:\/\/.+\/([\w-]+)\/([\w-]+)\.git)");
-    std::smatch match;
-    if (!std::regex_search(url, match, git_url_regex)) {
+    std::filesystem::path ext_path;
+    if (!s_git_import_resolver->get_target(url, ext_path)) {
         luaL_error(L, "Unsupported git url: \"%s\"", url.c_str());
         throw std::runtime_error("Unsupported git url");
     }
+    const auto ext_str = ext_path.string();
 
-    const auto owner = match[1].str();
-    const auto name  = match[2].str();
-
-    const auto ext_path = s_output_path / EXTERNAL_TEMP_LOCATION / (owner + "_" + name);
-    const auto ext_str  = ext_path.string();
-
-    if (std::filesystem::exists(ext_path)) {
-        GIT git(ext_path);
-        if (!git.is_git_repository()) {
-            luaL_error(
-                s_MainLuaState,
-                "Failed to update repository \"%s\" at \"%s\"\nDirectory is not a git repository\nPotential fix: Delete the directory and reconfigure",
-                url.c_str(),
-                ext_str.c_str());
-            throw std::runtime_error("Import git existing target directory is not a git repository");
-        }
-
-        if (!git.is_git_root()) {
-            luaL_error(
-                s_MainLuaState,
-                "Failed to update repository \"%s\" at \"%s\"\nDirectory is not a git repository root directory\nPotential fix: Delete the directory and reconfigure",
-                url.c_str(),
-                ext_str.c_str());
-            throw std::runtime_error("Import git existing target directory is not a git repository root directory");
-        }
-
-        if (GlobalConfig::skip_git_import_update()) {
-            Log.trace("Skip repository update [{}]\n    ({})", ext_path, url);
-        } else {
-            if (git.have_changes()) {
-                Log.warn("Not updating git repository \"{}\" - uncommitted changes\n    ({})", ext_path, url);
-            } else {
-                Log.trace("Pull repository updates [{}]\n    ({})", ext_path, url);
-                // git.fetch();
-                if (git.checkout(branch))
-                    git.pull();
-            }
-        }
-    } else {
-        Log.info("Clone \"{}\" to \"{}_{}\"", url, owner, name);
-        const bool cloned = GIT::clone_branch(ext_path, url, branch);
-
-        if (!cloned) {
-            luaL_error(s_MainLuaState, "Failed to clone repository \"%s\" to \"%s\"", url.c_str(), ext_str.c_str());
-            throw std::runtime_error("Import git clone failed");
-        }
+    const auto result = s_git_import_resolver->resolve(url, branch);
+    if (!result.success) {
+        luaL_error(s_MainLuaState, "%s", result.error.c_str());
+        throw std::runtime_error("Import git failed");
     }
+    BuildPlan::record_input(BuildPlan::InputType::GIT_HEAD, ext_str, GIT(ext_path).get_head_commit());
 
     if (arg_count > 2) {
         lua_insert(L, -3);                  // move arg to top
@@ -696,6 +1466,7 @@ Component& Project::lua_create_library(const std::string& base_name) {
                                             s_script_path_stack.back(),
                                             s_output_path / BUILD_TEMP_LOCATION / name,
                                             s_current_namespace);
+    comp->set_thin_archive(s_thin_archives);
     s_components.push_back(comp);
     return *comp.get();
 }
@@ -11,7 +11,15 @@ public:
 
     static void configure();
     static void build(const std::vector<std::string>& components);
+    /// configure() and build() in one pass - sources start compiling while other sources are still being configured
+    static void configure_and_build(const std::vector<std::string>& components);
     static void clean(const std::vector<std::string>& components);
+    /// Build again after sources, headers or scripts changed - scripts are only executed again if they changed
+    static void watch(const std::vector<std::string>& components);
+    /// Clean and build the configured project again (--daemon) - scripts are only executed again if they changed
+    static void build_resident(const std::vector<std::string>& clean_components, const std::vector<std::string>& components);
+    /// Log name, type and script of all components
+    static void log_components();
 
 private:
     static void initialize_lua();
@@ -24,9 +32,14 @@ private: // .cfxs-build Lua bindings
     static std::string lua_get_current_script_path(lua_State*);
 
     static void lua_set_namespace(const std::string& ns);
+    static void lua_set_thin_archives(bool enabled);
 
     static bool lua_have_var(const std::string& var_name);
 
+    // Build plan inputs read by os library functions
+    static void lua_cfxs_record_env(const std::string& name, bool is_set, const std::string& value);
+    static void lua_cfxs_record_volatile();
+
     // Import
     static void lua_import(lua_State* L);
     static void lua_import_git(lua_State* L);
@@ -35,4 +35,6 @@ struct CompileEntry {
     const Compiler* compiler;
     std::unique_ptr<SourceEntry> source_entry;
     std::vector<std::string> compile_args;
+    uint64_t command_hash; // hash of compiler + source + args - identifies this job between builds
+    uint64_t fingerprint;  // hash of compiler identity + args + precompiled header state - object is rebuilt when it changes
 };
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+namespace HashUtils {
+
+    static constexpr uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    static constexpr uint64_t FNV1A_PRIME        = 0x100000001b3ULL;
+
+    /// 64-bit FNV-1a - for short keys and fingerprints (not for file contents)
+    inline uint64_t fnv1a(std::string_view data, uint64_t hash = FNV1A_OFFSET_BASIS) {
+        for (const auto c : data) {
+            hash ^= (uint8_t)c;
+            hash *= FNV1A_PRIME;
+        }
+        return hash;
+    }
+
+    /// Continue fnv1a hash with a string followed by a separator byte
+    /// ("ab" + "c" and "a" + "bc" produce different hashes)
+    inline uint64_t fnv1a_field(std::string_view data, uint64_t hash = FNV1A_OFFSET_BASIS) {
+        hash = fnv1a(data, hash);
+        hash ^= 0xFF;
+        hash *= FNV1A_PRIME;
+        return hash;
+    }
+
+} // namespace HashUtils
@@ -0,0 +1,85 @@
+#pragma once
+#include <filesystem>
+#include <string_view>
+#include <string>
+#ifdef WINDOWS_BUILD
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// Read-only view of a whole file
+/// Large files are memory mapped where available - small files are read, mapping them costs more than copying
+class MappedFile {
+public:
+    static constexpr size_t MAP_THRESHOLD = 256 * 1024;
+
+    MappedFile(const std::filesystem::path& path) {
+#ifdef WINDOWS_BUILD
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return;
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data    = m_buffer.data();
+        m_size    = m_buffer.size();
+        m_is_open = true;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            m_is_open = true;
+            m_size    = st.st_size;
+            if (m_size >= MAP_THRESHOLD) {
+                void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    m_data   = static_cast<const char*>(data);
+                    m_mapped = true;
+                } else {
+                    m_is_open = false;
+                    m_size    = 0;
+                }
+            } else if (m_size) {
+                m_buffer.resize(m_size);
+                size_t offset = 0;
+                while (offset < m_size) {
+                    const auto n = ::read(fd, m_buffer.data() + offset, m_size - offset);
+                    if (n <= 0)
+                        break;
+                    offset += n;
+                }
+                m_size = offset; // file may have been truncated
+                m_data = m_buffer.data();
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef WINDOWS_BUILD
+        if (m_mapped)
+            munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return m_is_open; }
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    std::string_view view() const { return {m_data ? m_data : "", m_size}; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size      = 0;
+    bool m_is_open     = false;
+    bool m_mapped      = false;
+    std::string m_buffer;
+};
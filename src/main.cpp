@@ -4,6 +4,9 @@
 #include <exception>
 #include <filesystem>
 #include "Core/Project.hpp"
+#include "Core/Benchmarks.hpp"
+#include "Core/BuildDaemon.hpp"
+#include "Core/Jobserver.hpp"
 #include "CommandUtils.hpp"
 #include <fstream>
 
@@ -31,6 +34,18 @@ int get_max_ram_usage() {
 static bool s_config_skip_git_import_update = false;
 bool GlobalConfig::skip_git_import_update() { return s_config_skip_git_import_update; }
 
+static bool s_update_imports = false;
+bool GlobalConfig::update_imports() { return s_update_imports; }
+
+static bool s_offline_imports = false;
+bool GlobalConfig::offline_imports() { return s_offline_imports; }
+
+static bool s_frozen_imports = false;
+bool GlobalConfig::frozen_imports() { return s_frozen_imports; }
+
+static int s_git_cache_size_mb = 2048;
+int GlobalConfig::git_cache_size_mb() { return s_git_cache_size_mb; }
+
 static int s_number_of_worker_threads = 0;
 int GlobalConfig::number_of_worker_threads() {
     if (s_number_of_worker_threads == 0) {
@@ -40,6 +55,33 @@ int GlobalConfig::number_of_worker_threads() {
     }
 }
 
+static double s_max_load_average = 0;
+double GlobalConfig::max_load_average() { return s_max_load_average; }
+
+static bool s_keep_going = false;
+bool GlobalConfig::keep_going() { return s_keep_going; }
+
+static bool s_adaptive_jobs = false;
+bool GlobalConfig::adaptive_jobs() { return s_adaptive_jobs; }
+
+static bool s_use_jobserver = true;
+bool GlobalConfig::use_jobserver() { return s_use_jobserver; }
+
+static bool s_content_hash = false;
+bool GlobalConfig::content_hash() { return s_content_hash; }
+
+static bool s_ignore_debug_changes = false;
+bool GlobalConfig::ignore_debug_changes() { return s_ignore_debug_changes; }
+
+static bool s_use_build_plan = true;
+bool GlobalConfig::use_build_plan() { return s_use_build_plan; }
+
+static bool s_watch = false;
+bool GlobalConfig::watch() { return s_watch; }
+
+static bool s_daemon = false;
+bool GlobalConfig::daemon() { return s_daemon; }
+
 static bool s_generate_compile_commands = false;
 bool GlobalConfig::generate_compile_commands() { return s_generate_compile_commands; }
 
@@ -51,6 +93,47 @@ bool GlobalConfig::log_script_printf_locations() { return s_log_script_printf_lo
 
 std::vector<std::string> e_script_definitions;
 
+/// Run requested configure, clean and build steps - return exit code
+static int configure_clean_and_build(argparse::ArgumentParser &args) {
+    const auto build_projects = args.get<std::vector<std::string>>("--build");
+    const auto clean_projects = args.get<std::vector<std::string>>("--clean");
+
+    // clean has to run between configure and build - no pipelining
+    if (args["--configure"] == true && !build_projects.empty() && clean_projects.empty()) {
+        try {
+            Project::configure_and_build(build_projects);
+        } catch (const std::runtime_error &e) {
+            Log.error("Failed to build project: {}", e.what());
+            return -1;
+        }
+    } else {
+        if (args["--configure"] == true) {
+            try {
+                Project::configure();
+            } catch (const std::runtime_error &e) {
+                Log.error("Failed to configure project: {}", e.what());
+                return -1;
+            }
+        }
+
+        try {
+            Project::clean(clean_projects);
+        } catch (const std::runtime_error &e) {
+            Log.error("Failed to clean project: {}", e.what());
+            return -1;
+        }
+
+        try {
+            Project::build(build_projects);
+        } catch (const std::runtime_error &e) {
+            Log.error("Failed to build project: {}", e.what());
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char **argv) {
@@ -84,12 +167,78 @@ int main(int argc, char **argv) {
         .help("Skip git import update checks")    //
         .flag();
 
+    args.add_argument("--update-imports")                                      //
+        .help("Update git imports to their branch head instead of cfxs.lock")  //
+        .flag();                                                               //
+
+    args.add_argument("--offline")                                             //
+        .help("Use existing git import checkouts without running git")         //
+        .flag();                                                               //
+
+    args.add_argument("--frozen")                                              //
+        .help("Like --offline, but fail if a checkout differs from cfxs.lock") //
+        .flag();                                                               //
+
+    args.add_argument("--git-cache-size")                                       //
+        .default_value("2048")                                                  //
+        .help("Size limit of shared git import mirrors in MB (0 = no mirrors)") //
+        .nargs(1);                                                              //
+
     args.add_argument("--parallel")                                                   //
         .default_value("0")                                                           //
         .implicit_value("0")                                                          //
         .help("Specify number of parallel threads to use (not specified or 0 = all)") //
         .nargs(1);                                                                    //
 
+    args.add_argument("-l")                                                           //
+        .default_value("0")                                                           //
+        .help("Do not start new jobs if load average is above <load> (0 = no limit)") //
+        .nargs(1);                                                                    //
+
+    args.add_argument("-k", "--keep-going")                                           //
+        .help("Keep building jobs that do not depend on failed jobs")                 //
+        .flag();                                                                      //
+
+    args.add_argument("--adaptive-jobs")                                              //
+        .help("Run fewer jobs while the system is under memory pressure (Linux)")     //
+        .flag();                                                                      //
+
+    args.add_argument("--no-jobserver")                                               //
+        .help("Do not join or create a make jobserver")                               //
+        .flag();                                                                      //
+
+    args.add_argument("--content-hash")                                               //
+        .help("Do not rebuild if only modified times changed (compare file contents)") //
+        .flag();                                                                      //
+
+    args.add_argument("--ignore-debug-changes")                                       //
+        .help("Do not archive/link again if only debug info of objects changed (ELF)") //
+        .flag();                                                                      //
+
+    args.add_argument("--no-build-plan")                                              //
+        .help("Always execute build scripts (do not use the saved build plan)")       //
+        .flag();                                                                      //
+
+    args.add_argument("--watch")                                                      //
+        .help("Build again when sources, headers or build scripts change (Linux)")    //
+        .flag();                                                                      //
+
+    args.add_argument("--daemon")                                                     //
+        .help("Keep the configured project in memory and build for --connect clients") //
+        .flag();                                                                      //
+
+    args.add_argument("--connect")                                                    //
+        .help("Send --clean/--build/--query to the running --daemon of the project") //
+        .flag();                                                                      //
+
+    args.add_argument("--query")                                                      //
+        .help("Daemon query with --connect (components, status)")                    //
+        .nargs(1);                                                                    //
+
+    args.add_argument("--stop-daemon")                                                //
+        .help("Stop the running --daemon of the project")                            //
+        .flag();                                                                      //
+
     args.add_argument("-c")                                                           //
         .help("Generate compile_commands.json")                                       //
         .flag();                                                                      //
@@ -102,6 +251,14 @@ int main(int argc, char **argv) {
         .help("Log script printf locations")                                          //
         .flag();                                                                      //
 
+    args.add_argument("--benchmark-spawn")                                            //
+        .help("Measure process spawn latency with <n> trivial processes and exit")    //
+        .nargs(1);                                                                    //
+
+    args.add_argument("--benchmark-dep-parser")                                       //
+        .help("Measure dependency file parsing with <n> iterations and exit")         //
+        .nargs(1);                                                                    //
+
     args.add_argument("definitions").remaining();
 
     try {
@@ -122,6 +279,26 @@ int main(int argc, char **argv) {
 
     Log.info("CFXS Build v{}", version_string);
 
+    if (args.is_used("--benchmark-spawn")) {
+        try {
+            Benchmarks::process_spawn(std::stoi(args.get<std::string>("--benchmark-spawn")));
+        } catch (const std::exception& e) {
+            Log.error("Spawn benchmark failed: {}", e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    if (args.is_used("--benchmark-dep-parser")) {
+        try {
+            Benchmarks::dependency_parser(std::stoi(args.get<std::string>("--benchmark-dep-parser")));
+        } catch (const std::exception& e) {
+            Log.error("Dependency parser benchmark failed: {}", e.what());
+            return 1;
+        }
+        return 0;
+    }
+
     auto project_path = std::filesystem::path(args.get<std::string>("project"));
     auto output_path  = std::filesystem::path(args.get<std::string>("--out")) / ".cfxs/build";
 
@@ -147,11 +324,38 @@ int main(int argc, char **argv) {
         std::cout << "No files provided" << std::endl;
     }
 
+    // thin client - the daemon builds with its own options
+    if (args["--connect"] == true || args["--stop-daemon"] == true) {
+        BuildDaemon::Request request;
+        request.clean = args.get<std::vector<std::string>>("--clean");
+        request.build = args.get<std::vector<std::string>>("--build");
+        request.query = args.is_used("--query") ? args.get<std::string>("--query") : "";
+        request.stop  = args["--stop-daemon"] == true;
+        try {
+            return BuildDaemon::send(BuildDaemon::get_socket_path(output_path), request);
+        } catch (const std::runtime_error &e) {
+            return 1;
+        }
+    }
+
     try {
         if (args["--skip-git-import-update"] == true) {
             s_config_skip_git_import_update = true;
         }
 
+        if (args["--update-imports"] == true) {
+            s_update_imports = true;
+        }
+
+        if (args["--offline"] == true) {
+            s_offline_imports = true;
+        }
+
+        if (args["--frozen"] == true) {
+            s_offline_imports = true;
+            s_frozen_imports  = true;
+        }
+
         if (args["--printf-sources"] == true) {
             s_log_script_printf_locations = true;
         }
@@ -160,41 +364,120 @@ int main(int argc, char **argv) {
             s_generate_compile_commands = true;
         }
 
-        auto parallel_param = args.get<std::string>("--parallel");
-        for (uint32_t i = 1; i <= std::thread::hardware_concurrency(); i++) {
-            if (parallel_param == std::to_string(i)) {
-                s_number_of_worker_threads = i;
-                Log.info("Set parallel threads to {}", i);
-                break;
+        const auto parallel_param = args.get<std::string>("--parallel");
+        try {
+            const auto parallel = std::stoi(parallel_param);
+            if (parallel < 0) {
+                throw std::invalid_argument("negative");
+            }
+            if (parallel > 0) {
+                s_number_of_worker_threads = parallel;
+                Log.info("Set parallel threads to {}", parallel);
+            }
+        } catch (const std::exception& e) {
+            Log.error("Invalid --parallel value \"{}\"", parallel_param);
+            return 1;
+        }
+
+        const auto git_cache_size_param = args.get<std::string>("--git-cache-size");
+        try {
+            s_git_cache_size_mb = std::stoi(git_cache_size_param);
+            if (s_git_cache_size_mb < 0) {
+                throw std::invalid_argument("negative");
+            }
+        } catch (const std::exception& e) {
+            Log.error("Invalid --git-cache-size value \"{}\"", git_cache_size_param);
+            return 1;
+        }
+
+        const auto load_param = args.get<std::string>("-l");
+        try {
+            s_max_load_average = std::stod(load_param);
+            if (s_max_load_average > 0) {
+                Log.info("Set max load average to {:.2f}", s_max_load_average);
+            }
+        } catch (const std::exception& e) {
+            Log.error("Invalid -l value \"{}\"", load_param);
+            return 1;
+        }
+
+        if (args["--keep-going"] == true) {
+            s_keep_going = true;
+        }
+
+        if (args["--adaptive-jobs"] == true) {
+            s_adaptive_jobs = true;
+        }
+
+        if (args["--no-jobserver"] == true) {
+            s_use_jobserver = false;
+        }
+
+        if (args["--content-hash"] == true) {
+            s_content_hash = true;
+        }
+
+        if (args["--ignore-debug-changes"] == true) {
+            s_ignore_debug_changes = true;
+        }
+
+        if (args["--no-build-plan"] == true) {
+            s_use_build_plan = false;
+        }
+
+        if (args["--watch"] == true) {
+            // the configured components are kept to build again
+            if (args["--configure"] != true || args.get<std::vector<std::string>>("--build").empty()) {
+                Log.error("--watch requires --configure and --build");
+                return -1;
+            }
+            s_watch = true;
+        }
+
+        if (args["--daemon"] == true) {
+            if (GlobalConfig::watch()) {
+                Log.error("--daemon can not be used with --watch");
+                return -1;
             }
+            s_daemon = true;
+        }
+
+        // before any process is started, so children inherit the jobserver
+        if (GlobalConfig::use_jobserver()) {
+            Jobserver::initialize(GlobalConfig::number_of_worker_threads());
         }
 
         Project::initialize(project_path, output_path);
 
-        if (args["--configure"] == true) {
+        if (GlobalConfig::daemon()) {
+            // requests are still handled if the first configure failed - the scripts are executed again
             try {
                 Project::configure();
             } catch (const std::runtime_error &e) {
                 Log.error("Failed to configure project: {}", e.what());
+            }
+
+            try {
+                BuildDaemon::serve(BuildDaemon::get_socket_path(output_path));
+            } catch (const std::runtime_error &e) {
+                Log.error("Build daemon failed: {}", e.what());
                 return -1;
             }
+            return 0;
         }
 
-        const auto build_projects = args.get<std::vector<std::string>>("--build");
-        const auto clean_projects = args.get<std::vector<std::string>>("--clean");
-
-        try {
-            Project::clean(clean_projects);
-        } catch (const std::runtime_error &e) {
-            Log.error("Failed to clean project: {}", e.what());
-            return -1;
-        }
+        const int result = configure_clean_and_build(args);
 
-        try {
-            Project::build(build_projects);
-        } catch (const std::runtime_error &e) {
-            Log.error("Failed to build project: {}", e.what());
-            return -1;
+        if (GlobalConfig::watch()) {
+            // a failed build is built again after the next change
+            try {
+                Project::watch(args.get<std::vector<std::string>>("--build"));
+            } catch (const std::runtime_error &e) {
+                Log.error("Failed to watch project: {}", e.what());
+                return -1;
+            }
+        } else if (result != 0) {
+            return result;
         }
     } catch (const std::runtime_error &e) {
         return 1;